@@ -2,7 +2,92 @@
 #define LKG_CAMERA_H
 
 #include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <vector>
+
+// Matrix4::inverse runs on SSE or NEON when the target has them. Define
+// LKG_CAMERA_NO_SIMD to force the scalar path. Multiply and transpose stay scalar:
+// camera_benchmark measured no gain from vectorizing them.
+#if !defined(LKG_CAMERA_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define LKG_CAMERA_SSE
+#include <xmmintrin.h>
+#elif !defined(LKG_CAMERA_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define LKG_CAMERA_NEON
+#include <arm_neon.h>
+#endif
+
+// Four-lane float operations the Matrix4 inverse is written against, so the
+// kernel itself is shared by every backend. Load and Store need 16-byte
+// aligned pointers.
+namespace lkg_simd
+{
+#if defined(LKG_CAMERA_SSE)
+    typedef __m128 Vec4;
+
+    inline Vec4 Load(const float* p) { return _mm_load_ps(p); }
+    inline void Store(float* p, Vec4 v) { _mm_store_ps(p, v); }
+    inline Vec4 Splat(float f) { return _mm_set1_ps(f); }
+    inline Vec4 Add(Vec4 a, Vec4 b) { return _mm_add_ps(a, b); }
+    inline Vec4 Sub(Vec4 a, Vec4 b) { return _mm_sub_ps(a, b); }
+    inline Vec4 Mul(Vec4 a, Vec4 b) { return _mm_mul_ps(a, b); }
+    inline float First(Vec4 v) { return _mm_cvtss_f32(v); }
+
+    // (a, b, c, d) -> (b, a, d, c)
+    inline Vec4 SwapPairs(Vec4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+    // (a, b, c, d) -> (c, d, a, b)
+    inline Vec4 SwapHalves(Vec4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+
+    inline void Transpose(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+#elif defined(LKG_CAMERA_NEON)
+    typedef float32x4_t Vec4;
+
+    inline Vec4 Load(const float* p) { return vld1q_f32(p); }
+    inline void Store(float* p, Vec4 v) { vst1q_f32(p, v); }
+    inline Vec4 Splat(float f) { return vdupq_n_f32(f); }
+    inline Vec4 Add(Vec4 a, Vec4 b) { return vaddq_f32(a, b); }
+    inline Vec4 Sub(Vec4 a, Vec4 b) { return vsubq_f32(a, b); }
+    inline Vec4 Mul(Vec4 a, Vec4 b) { return vmulq_f32(a, b); }
+    inline float First(Vec4 v) { return vgetq_lane_f32(v, 0); }
+    inline Vec4 SwapPairs(Vec4 v) { return vrev64q_f32(v); }
+    inline Vec4 SwapHalves(Vec4 v) { return vextq_f32(v, v, 2); }
+
+    inline void Transpose(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3)
+    {
+        float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+#else
+    struct Vec4
+    {
+        float v[4];
+    };
+
+    inline Vec4 Load(const float* p) { return Vec4{ { p[0], p[1], p[2], p[3] } }; }
+    inline void Store(float* p, Vec4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+    inline Vec4 Splat(float f) { return Vec4{ { f, f, f, f } }; }
+    inline Vec4 Add(Vec4 a, Vec4 b) { return Vec4{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+    inline Vec4 Sub(Vec4 a, Vec4 b) { return Vec4{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+    inline Vec4 Mul(Vec4 a, Vec4 b) { return Vec4{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+    inline float First(Vec4 a) { return a.v[0]; }
+    inline Vec4 SwapPairs(Vec4 a) { return Vec4{ { a.v[1], a.v[0], a.v[3], a.v[2] } }; }
+    inline Vec4 SwapHalves(Vec4 a) { return Vec4{ { a.v[2], a.v[3], a.v[0], a.v[1] } }; }
+
+    inline void Transpose(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3)
+    {
+        Vec4 t0 = r0, t1 = r1, t2 = r2, t3 = r3;
+        r0 = Vec4{ { t0.v[0], t1.v[0], t2.v[0], t3.v[0] } };
+        r1 = Vec4{ { t0.v[1], t1.v[1], t2.v[1], t3.v[1] } };
+        r2 = Vec4{ { t0.v[2], t1.v[2], t2.v[2], t3.v[2] } };
+        r3 = Vec4{ { t0.v[3], t1.v[3], t2.v[3], t3.v[3] } };
+    }
+#endif
+}
 
 class Vector3
 {
@@ -79,7 +164,11 @@ public:
 class Matrix4
 {
 public:
-    float m[16];
+    alignas(16) float m[16];
+
+    // Tag for the constructor that leaves m uninitialized, for results that are
+    // about to be overwritten in full.
+    struct Uninitialized {};
 
     // Constructors
     Matrix4()
@@ -87,6 +176,10 @@ public:
         std::memset(m, 0, 16 * sizeof(float));
     }
 
+    explicit Matrix4(Uninitialized)
+    {
+    }
+
     Matrix4(const float* values)
     {
         std::memcpy(m, values, 16 * sizeof(float));
@@ -106,8 +199,8 @@ public:
     // Multiplication
     Matrix4 operator*(const Matrix4& other) const
     {
-        Matrix4 result;
         // Multiply two 4x4 matrices in column-major order
+        Matrix4 result{ Uninitialized() };
         for (int i = 0; i < 4; ++i) // Columns
         {
             for (int j = 0; j < 4; ++j) // Rows
@@ -121,6 +214,91 @@ public:
         return result;
     }
 
+    Matrix4 transposed() const
+    {
+        Matrix4 result{ Uninitialized() };
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                result.m[j * 4 + i] = m[i * 4 + j];
+            }
+        }
+        return result;
+    }
+
+    // Inverse by Cramer's rule on the transposed matrix (after Intel AP-928). A
+    // singular matrix yields non-finite values.
+    Matrix4 inverse() const
+    {
+        using namespace lkg_simd;
+
+        Vec4 row0 = Load(m + 0);
+        Vec4 row1 = Load(m + 4);
+        Vec4 row2 = Load(m + 8);
+        Vec4 row3 = Load(m + 12);
+        Transpose(row0, row1, row2, row3);
+        row1 = SwapHalves(row1);
+        row3 = SwapHalves(row3);
+
+        Vec4 minor0, minor1, minor2, minor3, tmp;
+
+        tmp = SwapPairs(Mul(row2, row3));
+        minor0 = Mul(row1, tmp);
+        minor1 = Mul(row0, tmp);
+        tmp = SwapHalves(tmp);
+        minor0 = Sub(Mul(row1, tmp), minor0);
+        minor1 = SwapHalves(Sub(Mul(row0, tmp), minor1));
+
+        tmp = SwapPairs(Mul(row1, row2));
+        minor0 = Add(Mul(row3, tmp), minor0);
+        minor3 = Mul(row0, tmp);
+        tmp = SwapHalves(tmp);
+        minor0 = Sub(minor0, Mul(row3, tmp));
+        minor3 = SwapHalves(Sub(Mul(row0, tmp), minor3));
+
+        tmp = SwapPairs(Mul(SwapHalves(row1), row3));
+        row2 = SwapHalves(row2);
+        minor0 = Add(Mul(row2, tmp), minor0);
+        minor2 = Mul(row0, tmp);
+        tmp = SwapHalves(tmp);
+        minor0 = Sub(minor0, Mul(row2, tmp));
+        minor2 = SwapHalves(Sub(Mul(row0, tmp), minor2));
+
+        tmp = SwapPairs(Mul(row0, row1));
+        minor2 = Add(Mul(row3, tmp), minor2);
+        minor3 = Sub(Mul(row2, tmp), minor3);
+        tmp = SwapHalves(tmp);
+        minor2 = Sub(Mul(row3, tmp), minor2);
+        minor3 = Sub(minor3, Mul(row2, tmp));
+
+        tmp = SwapPairs(Mul(row0, row3));
+        minor1 = Sub(minor1, Mul(row2, tmp));
+        minor2 = Add(Mul(row1, tmp), minor2);
+        tmp = SwapHalves(tmp);
+        minor1 = Add(Mul(row2, tmp), minor1);
+        minor2 = Sub(minor2, Mul(row1, tmp));
+
+        tmp = SwapPairs(Mul(row0, row2));
+        minor1 = Add(Mul(row3, tmp), minor1);
+        minor3 = Sub(minor3, Mul(row1, tmp));
+        tmp = SwapHalves(tmp);
+        minor1 = Sub(minor1, Mul(row3, tmp));
+        minor3 = Add(Mul(row1, tmp), minor3);
+
+        Vec4 det = Mul(row0, minor0);
+        det = Add(SwapHalves(det), det);
+        det = Add(SwapPairs(det), det);
+        Vec4 invDet = Splat(1.0f / First(det));
+
+        Matrix4 result{ Uninitialized() };
+        Store(result.m + 0, Mul(invDet, minor0));
+        Store(result.m + 4, Mul(invDet, minor1));
+        Store(result.m + 8, Mul(invDet, minor2));
+        Store(result.m + 12, Mul(invDet, minor3));
+        return result;
+    }
+
     // Helper method to create an identity matrix
     static Matrix4 Identity()
     {
@@ -136,6 +314,25 @@ public:
 class LKGCamera
 {
 public:
+    // How eye depth maps to the depth buffer.
+    //
+    // Standard is the OpenGL default: near -> -1, far -> 1 in clip space.
+    // ReversedZ maps near -> 1 and far -> 0 and expects glClipControl(GL_LOWER_LEFT,
+    // GL_ZERO_TO_ONE), glClearDepth(0) and glDepthFunc(GL_GEQUAL). With a
+    // GL_DEPTH_COMPONENT32F buffer the float exponent then cancels the perspective
+    // loss of precision with distance. ReversedInfiniteZ does the same with the far
+    // plane at infinity; farPlane is ignored for clipping.
+    //
+    // Fixed-point depth (16 or 24 bit) gains nothing from reversal; see
+    // depth_benchmark for the precision of each combination.
+    enum class DepthMode
+    {
+        Standard,
+        ReversedZ,
+        ReversedInfiniteZ,
+    };
+
+private:
     float size;        // Half-height of focal plane
     Vector3 center;    // Camera target (center)
     Vector3 up;        // Up vector
@@ -144,7 +341,20 @@ public:
     float aspectRatio; // Aspect ratio of the viewport
     float nearPlane;   // Near clipping plane
     float farPlane;    // Far clipping plane
+    DepthMode depthMode = DepthMode::Standard;
+
+    // Derived from the fields above and recomputed on first use after a setter
+    // changed one of them, so an unchanged camera does no trig per frame. Refreshing
+    // writes these from const accessors: give each thread its own camera, or
+    // synchronize access.
+    mutable bool derivedDirty = true;
+    mutable float cameraDistance = 0.0f;
+    mutable float cameraOffset = 0.0f;
+    mutable Matrix4 projection{ Matrix4::Uninitialized() };
 
+    uint64_t version = 1;
+
+public:
     LKGCamera()
         : size(10.0f),
         center(0.0f, 0.0f, 0.0f),
@@ -170,6 +380,44 @@ public:
     {
     }
 
+    float getSize() const { return size; }
+    const Vector3& getCenter() const { return center; }
+    const Vector3& getUp() const { return up; }
+    float getFov() const { return fov; }
+    float getViewcone() const { return viewcone; }
+    float getAspectRatio() const { return aspectRatio; }
+    float getNearPlane() const { return nearPlane; }
+    float getFarPlane() const { return farPlane; }
+    DepthMode getDepthMode() const { return depthMode; }
+
+    // Setters only count as a change, and bump the version, if the value differs.
+    void setSize(float value) { setDerivedInput(size, value); }
+    void setFov(float value) { setDerivedInput(fov, value); }
+    void setViewcone(float value) { setDerivedInput(viewcone, value); }
+    void setAspectRatio(float value) { setDerivedInput(aspectRatio, value); }
+    void setNearPlane(float value) { setDerivedInput(nearPlane, value); }
+    void setFarPlane(float value) { setDerivedInput(farPlane, value); }
+
+    void setDepthMode(DepthMode value)
+    {
+        if (depthMode != value)
+        {
+            depthMode = value;
+            derivedDirty = true;
+            version++;
+        }
+    }
+    void setCenter(const Vector3& value) { setVector(center, value); }
+    void setUp(const Vector3& value) { setVector(up, value); }
+
+    // Increases whenever a setter changes the camera. Anything built from the
+    // camera (uniform buffers, culling frusta) can store it and rebuild only when
+    // it differs.
+    uint64_t getVersion() const
+    {
+        return version;
+    }
+
     // Get the view matrix
     // Matrix4 getViewMatrix() const
     // {
@@ -179,7 +427,8 @@ public:
     // Get the projection matrix
     Matrix4 getProjectionMatrix() const
     {
-        return computeProjectionMatrix();
+        updateDerived();
+        return projection;
     }
 
     // Get the model matrix (e.g., for rotating an object)
@@ -191,12 +440,14 @@ public:
     // Get the camera's distance from center of focal plane, given FOV
     float getCameraDistance() const
     {
-        return size / tan(fov * (3.1415926535f / 180.0f));
+        updateDerived();
+        return cameraDistance;
     }
 
     float getCameraOffset() const
     {
-        return getCameraDistance() * tan(viewcone * (3.1415926535f / 180.0f));
+        updateDerived();
+        return cameraOffset;
     }
 
     // Compute view and projection matrices for hologram views
@@ -213,7 +464,7 @@ public:
         viewMatrix = computeViewMatrix(size, center, adjustedUp, offset);
 
         // Compute the standard projection matrix
-        projectionMatrix = computeProjectionMatrix();
+        projectionMatrix = getProjectionMatrix();
 
         // Apply frustum shift to the projection matrix
         float viewPosition = normalizedView;
@@ -225,7 +476,324 @@ public:
         projectionMatrix[8] += (offset * 2.0f / (size * aspectRatio)) + frustumShift;
     }
 
+    // View and projection matrices for every view of a quilt, one contiguous array
+    // per kind, indexed like the quilt (viewIndex = y * vx + x).
+    struct QuiltMatrices
+    {
+        std::vector<Matrix4> view;
+        std::vector<Matrix4> projection;
+    };
+
+    // Same result as calling computeViewProjectionMatrices for each of the vx * vy
+    // views with normalizedView = viewIndex / (vx * vy - 1), but the camera distance,
+    // offset, view basis and base projection are computed once; each view only
+    // differs in the view translation and the projection's frustum shift. A single
+    // view is treated as the center view.
+    void computeQuiltMatrices(int vx, int vy, bool invert, float offset_mult, float focus, QuiltMatrices& matrices) const
+    {
+        int totalViews = vx > 0 && vy > 0 ? vx * vy : 0;
+        matrices.view.resize(totalViews);
+        matrices.projection.resize(totalViews);
+        if (totalViews == 0)
+        {
+            return;
+        }
+
+        float offset = getCameraOffset();
+        Vector3 adjustedUp = invert ? Vector3(up.x, -up.y, up.z) : up;
+        Matrix4 baseView = computeViewMatrix(size, center, adjustedUp, 0.0f);
+        Matrix4 baseProjection = getProjectionMatrix();
+        float lastView = static_cast<float>(totalViews - 1);
+
+        for (int i = 0; i < totalViews; i++)
+        {
+            float normalizedView = totalViews > 1 ? static_cast<float>(i) / lastView : 0.5f;
+            float distanceFromCenter = normalizedView - 0.5f;
+            float viewOffset = -distanceFromCenter * offset_mult * offset;
+
+            Matrix4& viewMatrix = matrices.view[i];
+            viewMatrix = baseView;
+            viewMatrix[12] = viewOffset;
+
+            Matrix4& projectionMatrix = matrices.projection[i];
+            projectionMatrix = baseProjection;
+            projectionMatrix[8] += (viewOffset * 2.0f / (size * aspectRatio)) + distanceFromCenter * focus;
+        }
+    }
+
+    // Every view's projection * view written as one matrix plus a linear term, for
+    // shaders that derive the view from gl_InstanceID or gl_ViewID:
+    //
+    //   float d = firstView + float(viewIndex) * viewStep;
+    //   mat4 viewProjection = centerViewProjection + d * shear;
+    //
+    // where d is the view's normalizedView - 0.5. Within a quilt only the view
+    // translation and the projection's frustum shift change, and both are linear in
+    // normalizedView, so this is exact up to float rounding. Uploading it costs two
+    // matrices instead of two per view.
+    struct QuiltShear
+    {
+        Matrix4 centerViewProjection; // projection * view at normalizedView = 0.5
+        Matrix4 shear;                // change of projection * view per unit of normalizedView
+        float firstView;              // d of view 0: -0.5, or 0 for a single (center) view
+        float viewStep;               // d between adjacent views, 1 / (vx * vy - 1)
+    };
+
+    void computeQuiltShear(int vx, int vy, bool invert, float offset_mult, float focus, QuiltShear& quiltShear) const
+    {
+        int totalViews = vx > 0 && vy > 0 ? vx * vy : 0;
+
+        Matrix4 baseView{ Matrix4::Uninitialized() };
+        Matrix4 baseProjection{ Matrix4::Uninitialized() };
+        float viewSlope, projectionSlope;
+        computeQuiltBasis(invert, offset_mult, focus, baseView, baseProjection, viewSlope, projectionSlope);
+
+        // Matrix4::operator* composes right to left, so this is projection * view.
+        quiltShear.centerViewProjection = baseView * baseProjection;
+
+        // d/dd (P + projectionSlope * E02) * (V + viewSlope * E03): projection's
+        // column 0 moves into column 3, and view's row 2 into row 0.
+        Matrix4& shear = quiltShear.shear;
+        shear = Matrix4();
+        for (int r = 0; r < 4; r++)
+        {
+            shear[12 + r] += viewSlope * baseProjection[r];
+        }
+        for (int c = 0; c < 4; c++)
+        {
+            shear[c * 4] += projectionSlope * baseView[c * 4 + 2];
+        }
+
+        quiltShear.firstView = totalViews > 1 ? -0.5f : 0.0f;
+        quiltShear.viewStep = totalViews > 1 ? 1.0f / static_cast<float>(totalViews - 1) : 0.0f;
+    }
+
+    // Six world-space planes (left, right, bottom, top, near, far). A point p is
+    // inside plane i when planes[i][0] * p.x + planes[i][1] * p.y + planes[i][2] * p.z
+    // + planes[i][3] >= 0; planes are normalized, so that value is a distance.
+    struct Frustum
+    {
+        float planes[6][4];
+
+        // Planes of a projection * view matrix. Clip z runs from -w to w in Standard
+        // mode and from w (near) to 0 (far) in the reversed modes. An infinite far
+        // plane comes out as all zeros, which accepts everything.
+        static Frustum fromViewProjection(const Matrix4& viewProjection, DepthMode depthMode = DepthMode::Standard)
+        {
+            Frustum frustum;
+            for (int i = 0; i < 6; i++)
+            {
+                int axis = i / 2;
+                float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+                float wScale = 1.0f;
+                if (axis == 2 && depthMode != DepthMode::Standard)
+                {
+                    // near: w - z >= 0, far: z >= 0
+                    sign = -sign;
+                    wScale = i == 4 ? 1.0f : 0.0f;
+                }
+
+                float plane[4];
+                for (int c = 0; c < 4; c++)
+                {
+                    plane[c] = wScale * viewProjection[c * 4 + 3] + sign * viewProjection[c * 4 + axis];
+                }
+                setNormalized(frustum.planes[i], plane);
+            }
+            return frustum;
+        }
+
+        // Conservative: may accept a sphere that is just outside a corner.
+        bool intersectsSphere(const Vector3& center, float radius) const
+        {
+            for (int i = 0; i < 6; i++)
+            {
+                const float* plane = planes[i];
+                if (plane[0] * center.x + plane[1] * center.y + plane[2] * center.z + plane[3] < -radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void setNormalized(float* out, const float* plane)
+        {
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            float scale = length > 0.0f ? 1.0f / length : 0.0f;
+            for (int c = 0; c < 4; c++)
+            {
+                out[c] = plane[c] * scale;
+            }
+        }
+    };
+
+    // One frustum that contains every view of the quilt, for a coarse cull before
+    // the per-view loop. Views share their bottom, top, near and far planes; left and
+    // right are replaced by planes that bound the outermost views between the near
+    // and far plane.
+    Frustum computeQuiltUnionFrustum(int vx, int vy, bool invert, float offset_mult, float focus) const
+    {
+        int totalViews = vx > 0 && vy > 0 ? vx * vy : 0;
+        float lastView = totalViews > 1 ? 0.5f : 0.0f;
+        float firstView = -lastView;
+
+        Matrix4 baseView{ Matrix4::Uninitialized() };
+        Matrix4 baseProjection{ Matrix4::Uninitialized() };
+        float viewSlope, projectionSlope;
+        computeQuiltBasis(invert, offset_mult, focus, baseView, baseProjection, viewSlope, projectionSlope);
+
+        Matrix4 center = baseView * baseProjection;
+        Frustum frustum = Frustum::fromViewProjection(center, depthMode);
+
+        // View d has clip x = x + d * s, where s = viewSlope * P00 - projectionSlope * w
+        // only depends on clip w (see computeQuiltShear). A point is inside one side
+        // of some view if w + sign * x + g(w) >= 0, with g the best d's term. g is
+        // the max of two linear functions of w, so its chord between the near and far
+        // plane lies above it and gives a single conservative plane. Without a far
+        // plane, the line from g(near) with the steeper slope bounds it instead.
+        float nearW = nearPlane;
+        float farW = farPlane;
+        float sNear = viewSlope * baseProjection[0] - projectionSlope * nearW;
+        float sFar = viewSlope * baseProjection[0] - projectionSlope * farW;
+
+        for (int side = 0; side < 2; side++)
+        {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            float gNear = std::fmax(sign * firstView * sNear, sign * lastView * sNear);
+            float gFar = std::fmax(sign * firstView * sFar, sign * lastView * sFar);
+            float gSlope = farW != nearW ? (gFar - gNear) / (farW - nearW) : 0.0f;
+            if (depthMode == DepthMode::ReversedInfiniteZ)
+            {
+                gSlope = std::fmax(-sign * firstView * projectionSlope, -sign * lastView * projectionSlope);
+            }
+            float gConstant = gNear - gSlope * nearW;
+
+            float plane[4];
+            for (int c = 0; c < 4; c++)
+            {
+                float w = center[c * 4 + 3];
+                plane[c] = w + sign * center[c * 4] + gSlope * w;
+            }
+            plane[3] += gConstant;
+            Frustum::setNormalized(frustum.planes[side], plane);
+        }
+
+        return frustum;
+    }
+
+    // Planes of every view, stored plane-major so one plane of consecutive views is
+    // contiguous: a[plane * viewCount + view] and likewise b, c and d.
+    struct QuiltFrustums
+    {
+        int viewCount = 0;
+        std::vector<float> a, b, c, d;
+
+        // visible[view] is set to 1 if the sphere touches that view's frustum, else 0.
+        void intersectSphere(const Vector3& center, float radius, unsigned char* visible) const
+        {
+            intersectSphere(a.data(), b.data(), c.data(), d.data(), viewCount, center.x, center.y, center.z, -radius, visible);
+        }
+
+    private:
+        // Consecutive views are independent, so the loop vectorizes across views. The
+        // sphere is passed by value and the pointers are __restrict, or the stores to
+        // visible could alias the planes and every load would be redone.
+        static void intersectSphere(const float* __restrict pa, const float* __restrict pb, const float* __restrict pc, const float* __restrict pd, int n,
+                                    float x, float y, float z, float minDistance, unsigned char* __restrict visible)
+        {
+            for (int view = 0; view < n; view++)
+            {
+                float nearest = pa[view] * x + pb[view] * y + pc[view] * z + pd[view];
+                for (int plane = 1; plane < 6; plane++)
+                {
+                    int index = plane * n + view;
+                    float distance = pa[index] * x + pb[index] * y + pc[index] * z + pd[index];
+                    nearest = distance < nearest ? distance : nearest;
+                }
+                visible[view] = static_cast<unsigned char>(nearest >= minDistance);
+            }
+        }
+    };
+
+    void computeQuiltFrustums(int vx, int vy, bool invert, float offset_mult, float focus, QuiltFrustums& frustums) const
+    {
+        QuiltShear quiltShear;
+        computeQuiltShear(vx, vy, invert, offset_mult, focus, quiltShear);
+
+        int totalViews = vx > 0 && vy > 0 ? vx * vy : 0;
+        frustums.viewCount = totalViews;
+        frustums.a.resize(6 * totalViews);
+        frustums.b.resize(6 * totalViews);
+        frustums.c.resize(6 * totalViews);
+        frustums.d.resize(6 * totalViews);
+
+        for (int view = 0; view < totalViews; view++)
+        {
+            float d = quiltShear.firstView + float(view) * quiltShear.viewStep;
+            Matrix4 viewProjection{ Matrix4::Uninitialized() };
+            for (int i = 0; i < 16; i++)
+            {
+                viewProjection[i] = quiltShear.centerViewProjection[i] + d * quiltShear.shear[i];
+            }
+
+            Frustum frustum = Frustum::fromViewProjection(viewProjection, depthMode);
+            for (int plane = 0; plane < 6; plane++)
+            {
+                int index = plane * totalViews + view;
+                frustums.a[index] = frustum.planes[plane][0];
+                frustums.b[index] = frustum.planes[plane][1];
+                frustums.c[index] = frustum.planes[plane][2];
+                frustums.d[index] = frustum.planes[plane][3];
+            }
+        }
+    }
+
 private:
+    // The center view, its projection, and how view[12] and projection[8] change per
+    // unit of normalizedView (see computeViewProjectionMatrices).
+    void computeQuiltBasis(bool invert, float offset_mult, float focus, Matrix4& baseView, Matrix4& baseProjection, float& viewSlope, float& projectionSlope) const
+    {
+        viewSlope = -offset_mult * getCameraOffset();
+        projectionSlope = viewSlope * 2.0f / (size * aspectRatio) + focus;
+
+        Vector3 adjustedUp = invert ? Vector3(up.x, -up.y, up.z) : up;
+        baseView = computeViewMatrix(size, center, adjustedUp, 0.0f);
+        baseProjection = getProjectionMatrix();
+    }
+
+    void setDerivedInput(float& field, float value)
+    {
+        if (field != value)
+        {
+            field = value;
+            derivedDirty = true;
+            version++;
+        }
+    }
+
+    void setVector(Vector3& field, const Vector3& value)
+    {
+        if (field.x != value.x || field.y != value.y || field.z != value.z)
+        {
+            field = value;
+            version++;
+        }
+    }
+
+    void updateDerived() const
+    {
+        if (!derivedDirty)
+        {
+            return;
+        }
+
+        cameraDistance = size / tan(fov * (3.1415926535f / 180.0f));
+        cameraOffset = cameraDistance * tan(viewcone * (3.1415926535f / 180.0f));
+        projection = computeProjectionMatrix();
+        derivedDirty = false;
+    }
+
     // Helper method to compute the view matrix
     Matrix4 computeViewMatrix(float size, const Vector3& center, const Vector3& upVec, float offset) const
     {
@@ -287,9 +855,23 @@ private:
 
         matrix[0] = f / aspect;
         matrix[5] = f;
-        matrix[10] = (f_p + n) / (n - f_p);
         matrix[11] = -1.0f;
-        matrix[14] = (2 * f_p * n) / (n - f_p);
+
+        switch (depthMode)
+        {
+        case DepthMode::Standard:
+            matrix[10] = (f_p + n) / (n - f_p);
+            matrix[14] = (2 * f_p * n) / (n - f_p);
+            break;
+        case DepthMode::ReversedZ:
+            matrix[10] = n / (f_p - n);
+            matrix[14] = (f_p * n) / (f_p - n);
+            break;
+        case DepthMode::ReversedInfiniteZ:
+            matrix[10] = 0.0f;
+            matrix[14] = n;
+            break;
+        }
 
         return matrix;
     }
@@ -0,0 +1,336 @@
+#pragma once
+
+// On-disk cache of the display list, so an app can size its quilt and set up its
+// camera from the last known calibration before Bridge has answered a single
+// metadata query. Included by bridge_utils.hpp after DisplayInfo is declared.
+//
+// The file is a flat blob in host byte order, written for one machine:
+//
+//   header   magic "LKGD", format version, sizeof(wchar_t), Bridge version string
+//   count    number of displays
+//   display  DisplayInfo fields in declaration order, strings as length + code units,
+//            calibration cells as count + raw CalibrationSubpixelCell array
+//   trailer  FNV-1a 64 of everything before it
+//
+// A file written by another Bridge version, another format version or that fails
+// the checksum is ignored.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class DisplayCacheCodec
+{
+private:
+    static const uint32_t Magic = 0x44474B4C;   // "LKGD"
+    static const uint32_t FormatVersion = 1;
+
+    class Writer
+    {
+    public:
+        std::string bytes;
+
+        template<typename T>
+        void Put(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "raw write of a non-trivial type");
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void PutString(const std::string& value)
+        {
+            Put(uint32_t(value.size()));
+            bytes.append(value);
+        }
+
+        void PutWideString(const std::wstring& value)
+        {
+            Put(uint32_t(value.size()));
+            bytes.append(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(wchar_t));
+        }
+    };
+
+    class Reader
+    {
+    private:
+        const char* cur;
+        const char* end;
+
+    public:
+        bool ok = true;
+
+        Reader(const char* begin, const char* end)
+            : cur(begin), end(end)
+        {
+        }
+
+        template<typename T>
+        void Get(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "raw read of a non-trivial type");
+            if (!ok || size_t(end - cur) < sizeof(T))
+            {
+                ok = false;
+                return;
+            }
+            std::memcpy(&value, cur, sizeof(T));
+            cur += sizeof(T);
+        }
+
+        // Reads count elements of T, refusing counts that cannot fit in what is left.
+        template<typename T>
+        bool GetCount(uint32_t& count)
+        {
+            Get(count);
+            if (ok && uint64_t(count) * sizeof(T) > uint64_t(end - cur))
+            {
+                ok = false;
+            }
+            return ok;
+        }
+
+        void GetString(std::string& value)
+        {
+            uint32_t count = 0;
+            if (GetCount<char>(count))
+            {
+                value.assign(cur, count);
+                cur += count;
+            }
+        }
+
+        void GetWideString(std::wstring& value)
+        {
+            uint32_t count = 0;
+            if (GetCount<wchar_t>(count))
+            {
+                value.resize(count);
+                std::memcpy(&value[0], cur, count * sizeof(wchar_t));
+                cur += count * sizeof(wchar_t);
+            }
+        }
+
+        void GetCells(std::vector<CalibrationSubpixelCell>& cells)
+        {
+            uint32_t count = 0;
+            if (GetCount<CalibrationSubpixelCell>(count))
+            {
+                cells.resize(count);
+                if (count > 0)
+                {
+                    std::memcpy(cells.data(), cur, count * sizeof(CalibrationSubpixelCell));
+                }
+                cur += count * sizeof(CalibrationSubpixelCell);
+            }
+        }
+
+        bool AtEnd() const
+        {
+            return cur == end;
+        }
+    };
+
+    static uint64_t Checksum(const char* data, size_t size)
+    {
+        uint64_t hash = 1469598103934665603ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= uint8_t(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static void PutDisplay(Writer& out, const DisplayInfo& info)
+    {
+        out.Put(uint64_t(info.display_id));
+        out.PutWideString(info.serial);
+        out.PutWideString(info.name);
+        out.Put(uint64_t(info.dimensions.width));
+        out.Put(uint64_t(info.dimensions.height));
+        out.Put(int32_t(info.hw_enum));
+
+        const LKGCalibration& cal = info.calibration;
+        out.Put(cal.center);
+        out.Put(cal.pitch);
+        out.Put(cal.slope);
+        out.Put(int32_t(cal.width));
+        out.Put(int32_t(cal.height));
+        out.Put(cal.dpi);
+        out.Put(cal.flip_x);
+        out.Put(int32_t(cal.invView));
+        out.Put(cal.viewcone);
+        out.Put(cal.fringe);
+        out.Put(int32_t(cal.cell_pattern_mode));
+        out.Put(uint32_t(cal.cells.size()));
+        out.bytes.append(reinterpret_cast<const char*>(cal.cells.data()), cal.cells.size() * sizeof(CalibrationSubpixelCell));
+
+        out.Put(int32_t(info.viewinv));
+        out.Put(int32_t(info.ri));
+        out.Put(int32_t(info.bi));
+        out.Put(info.tilt);
+        out.Put(info.aspect);
+        out.Put(info.fringe);
+        out.Put(info.subp);
+        out.Put(info.viewcone);
+        out.Put(info.center);
+        out.Put(info.pitch);
+
+        const DefaultQuitSettings& quilt = info.default_quilt_settings;
+        out.Put(quilt.aspect);
+        out.Put(int32_t(quilt.quilt_width));
+        out.Put(int32_t(quilt.quilt_height));
+        out.Put(int32_t(quilt.quilt_columns));
+        out.Put(int32_t(quilt.quilt_rows));
+
+        out.Put(int64_t(info.window_position.x));
+        out.Put(int64_t(info.window_position.y));
+    }
+
+    template<typename Stored, typename T>
+    static void GetAs(Reader& in, T& value)
+    {
+        Stored stored = Stored();
+        in.Get(stored);
+        value = T(stored);
+    }
+
+    static void GetDisplay(Reader& in, DisplayInfo& info)
+    {
+        GetAs<uint64_t>(in, info.display_id);
+        in.GetWideString(info.serial);
+        in.GetWideString(info.name);
+        GetAs<uint64_t>(in, info.dimensions.width);
+        GetAs<uint64_t>(in, info.dimensions.height);
+        GetAs<int32_t>(in, info.hw_enum);
+
+        LKGCalibration& cal = info.calibration;
+        in.Get(cal.center);
+        in.Get(cal.pitch);
+        in.Get(cal.slope);
+        GetAs<int32_t>(in, cal.width);
+        GetAs<int32_t>(in, cal.height);
+        in.Get(cal.dpi);
+        in.Get(cal.flip_x);
+        GetAs<int32_t>(in, cal.invView);
+        in.Get(cal.viewcone);
+        in.Get(cal.fringe);
+        GetAs<int32_t>(in, cal.cell_pattern_mode);
+        in.GetCells(cal.cells);
+
+        GetAs<int32_t>(in, info.viewinv);
+        GetAs<int32_t>(in, info.ri);
+        GetAs<int32_t>(in, info.bi);
+        in.Get(info.tilt);
+        in.Get(info.aspect);
+        in.Get(info.fringe);
+        in.Get(info.subp);
+        in.Get(info.viewcone);
+        in.Get(info.center);
+        in.Get(info.pitch);
+
+        DefaultQuitSettings& quilt = info.default_quilt_settings;
+        in.Get(quilt.aspect);
+        GetAs<int32_t>(in, quilt.quilt_width);
+        GetAs<int32_t>(in, quilt.quilt_height);
+        GetAs<int32_t>(in, quilt.quilt_columns);
+        GetAs<int32_t>(in, quilt.quilt_rows);
+
+        GetAs<int64_t>(in, info.window_position.x);
+        GetAs<int64_t>(in, info.window_position.y);
+    }
+
+public:
+    // bridgeVersion is any string that identifies the running Bridge build; a cache
+    // written under a different one is rejected on load.
+    static std::string Encode(const std::string& bridgeVersion, const std::vector<DisplayInfo>& displays)
+    {
+        Writer out;
+        out.Put(uint32_t(Magic));
+        out.Put(uint32_t(FormatVersion));
+        out.Put(uint32_t(sizeof(wchar_t)));
+        out.PutString(bridgeVersion);
+
+        out.Put(uint32_t(displays.size()));
+        for (const auto& display : displays)
+        {
+            PutDisplay(out, display);
+        }
+
+        out.Put(Checksum(out.bytes.data(), out.bytes.size()));
+        return out.bytes;
+    }
+
+    static bool Decode(const std::string& bytes, const std::string& bridgeVersion, std::vector<DisplayInfo>& displays)
+    {
+        if (bytes.size() < sizeof(uint64_t))
+        {
+            return false;
+        }
+
+        size_t body = bytes.size() - sizeof(uint64_t);
+        uint64_t checksum = 0;
+        std::memcpy(&checksum, bytes.data() + body, sizeof(checksum));
+        if (checksum != Checksum(bytes.data(), body))
+        {
+            return false;
+        }
+
+        Reader in(bytes.data(), bytes.data() + body);
+
+        uint32_t magic = 0, format = 0, wcharSize = 0;
+        std::string version;
+        in.Get(magic);
+        in.Get(format);
+        in.Get(wcharSize);
+        in.GetString(version);
+
+        if (!in.ok || magic != Magic || format != FormatVersion || wcharSize != sizeof(wchar_t) || version != bridgeVersion)
+        {
+            return false;
+        }
+
+        uint32_t count = 0;
+        in.Get(count);
+
+        std::vector<DisplayInfo> decoded;
+        for (uint32_t i = 0; in.ok && i < count; i++)
+        {
+            decoded.emplace_back();
+            GetDisplay(in, decoded.back());
+        }
+
+        if (!in.ok || !in.AtEnd())
+        {
+            return false;
+        }
+
+        displays = std::move(decoded);
+        return true;
+    }
+
+    static bool ReadFile(const std::filesystem::path& path, std::string& bytes)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+
+        in.seekg(0, std::ios::end);
+        std::streamoff size = in.tellg();
+        in.seekg(0, std::ios::beg);
+        if (size <= 0)
+        {
+            return false;
+        }
+
+        bytes.resize(size_t(size));
+        in.read(&bytes[0], size);
+        return bool(in);
+    }
+};
@@ -0,0 +1,356 @@
+#pragma once
+
+// Opt-in latency instrumentation for the Controller wrappers.
+//
+// Define BRIDGE_INSTRUMENTATION before including bridge_utils.hpp (or add it to
+// the compile definitions) to record, per bridge.h entry point, the call count and
+// a latency histogram from which p50/p95/p99/max are reported. Without the define
+// BRIDGE_PROFILE_CALL expands to nothing and none of this is compiled.
+//
+// Every thread records into its own counter block, and only that thread writes
+// to it, so recording is a handful of relaxed stores with no lock and no shared
+// cache line. When a thread exits, its counts are folded into a shared retired
+// block and its own block is freed, so Dump() still includes them.
+
+#ifdef BRIDGE_INSTRUMENTATION
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class BridgeProfiler
+{
+public:
+    static const size_t MaxEntryPoints = 96;
+
+    // Log-linear buckets: 4 per power of two, from 1 ns up to about 2^40 ns.
+    // A reported percentile is the upper edge of its bucket, i.e. at most ~19% high.
+    static const size_t SubBuckets = 4;
+    static const size_t Octaves = 40;
+    static const size_t BucketCount = Octaves * SubBuckets;
+
+private:
+    struct EntryCounters
+    {
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> totalNs{ 0 };
+        std::atomic<uint64_t> maxNs{ 0 };
+        std::atomic<uint64_t> buckets[BucketCount] = {};
+    };
+
+    struct ThreadCounters
+    {
+        EntryCounters entries[MaxEntryPoints];
+    };
+
+    // Owns the calling thread's block and hands it back when the thread exits.
+    struct LocalCounters
+    {
+        ThreadCounters* counters = nullptr;
+
+        ~LocalCounters()
+        {
+            if (counters)
+            {
+                BridgeProfiler::Shared().Retire(counters);
+            }
+        }
+    };
+
+    std::mutex                                   mutex;
+    std::vector<std::unique_ptr<ThreadCounters>> threads;   // blocks of live threads
+    ThreadCounters                               retired;   // sums of exited threads, written under mutex
+    const char*                                  names[MaxEntryPoints] = {};
+    std::atomic<size_t>                          entryCount{ 0 };
+
+    ThreadCounters& Local()
+    {
+        thread_local LocalCounters local;
+        if (!local.counters)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.push_back(std::make_unique<ThreadCounters>());
+            local.counters = threads.back().get();
+        }
+        return *local.counters;
+    }
+
+    // Folds an exiting thread's counts into the retired block and frees its block.
+    void Retire(ThreadCounters* counters)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        size_t count = entryCount.load(std::memory_order_acquire);
+        for (size_t slot = 0; slot < count; slot++)
+        {
+            const EntryCounters& from = counters->entries[slot];
+            EntryCounters& into = retired.entries[slot];
+            Add(into.count, from.count.load(std::memory_order_relaxed));
+            Add(into.totalNs, from.totalNs.load(std::memory_order_relaxed));
+            uint64_t maxNs = from.maxNs.load(std::memory_order_relaxed);
+            if (maxNs > into.maxNs.load(std::memory_order_relaxed))
+            {
+                into.maxNs.store(maxNs, std::memory_order_relaxed);
+            }
+            for (size_t b = 0; b < BucketCount; b++)
+            {
+                Add(into.buckets[b], from.buckets[b].load(std::memory_order_relaxed));
+            }
+        }
+
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            if (threads[i].get() == counters)
+            {
+                threads.erase(threads.begin() + i);
+                break;
+            }
+        }
+    }
+
+    static void Clear(ThreadCounters& counters)
+    {
+        for (auto& entry : counters.entries)
+        {
+            entry.count.store(0, std::memory_order_relaxed);
+            entry.totalNs.store(0, std::memory_order_relaxed);
+            entry.maxNs.store(0, std::memory_order_relaxed);
+            for (auto& bucket : entry.buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Single-writer increment: only the owning thread (or Retire, under the mutex)
+    // stores to these counters.
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static size_t Bucket(uint64_t ns)
+    {
+        if (ns < SubBuckets)
+        {
+            return size_t(ns);
+        }
+
+        size_t octave = 63 - size_t(CountLeadingZeros(ns));
+        size_t sub = size_t(ns >> (octave - 2)) & (SubBuckets - 1);
+        size_t bucket = (octave - 1) * SubBuckets + sub;
+        return bucket < BucketCount ? bucket : BucketCount - 1;
+    }
+
+    // Largest value that lands in bucket.
+    static uint64_t BucketUpperBound(size_t bucket)
+    {
+        if (bucket < SubBuckets)
+        {
+            return uint64_t(bucket);
+        }
+
+        size_t octave = bucket / SubBuckets + 1;
+        uint64_t sub = bucket % SubBuckets;
+        return ((SubBuckets + sub + 1) << (octave - 2)) - 1;
+    }
+
+    static int CountLeadingZeros(uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int n = 0;
+        for (uint64_t bit = uint64_t(1) << 63; bit && !(value & bit); bit >>= 1)
+        {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+public:
+    static BridgeProfiler& Shared()
+    {
+        static BridgeProfiler profiler;
+        return profiler;
+    }
+
+    // Assigns a slot to an entry point name. Called once per wrapper through the
+    // function-local static in BRIDGE_PROFILE_CALL.
+    size_t Register(const char* name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        size_t count = entryCount.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (std::strcmp(names[i], name) == 0)
+            {
+                return i;
+            }
+        }
+
+        if (count >= MaxEntryPoints)
+        {
+            return MaxEntryPoints;
+        }
+
+        names[count] = name;
+        entryCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    void Record(size_t slot, uint64_t ns)
+    {
+        if (slot >= MaxEntryPoints)
+        {
+            return;
+        }
+
+        EntryCounters& entry = Local().entries[slot];
+        Add(entry.count, 1);
+        Add(entry.totalNs, ns);
+        Add(entry.buckets[Bucket(ns)], 1);
+        if (ns > entry.maxNs.load(std::memory_order_relaxed))
+        {
+            entry.maxNs.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    // Clears all counters. Calls racing with Reset may be partly kept.
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& thread : threads)
+        {
+            Clear(*thread);
+        }
+        Clear(retired);
+    }
+
+    // {"entry_points":[{"name":..,"count":..,"mean_ns":..,"p50_ns":..,"p95_ns":..,"p99_ns":..,"max_ns":..},...]}
+    // Entry points that were never called are left out.
+    std::string Dump()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::string json = "{\"entry_points\":[";
+        bool first = true;
+
+        size_t count = entryCount.load(std::memory_order_acquire);
+        for (size_t slot = 0; slot < count; slot++)
+        {
+            uint64_t calls = 0;
+            uint64_t totalNs = 0;
+            uint64_t maxNs = 0;
+            uint64_t buckets[BucketCount] = {};
+
+            auto sum = [&](const ThreadCounters& block)
+            {
+                const EntryCounters& entry = block.entries[slot];
+                calls += entry.count.load(std::memory_order_relaxed);
+                totalNs += entry.totalNs.load(std::memory_order_relaxed);
+                uint64_t threadMax = entry.maxNs.load(std::memory_order_relaxed);
+                maxNs = threadMax > maxNs ? threadMax : maxNs;
+                for (size_t b = 0; b < BucketCount; b++)
+                {
+                    buckets[b] += entry.buckets[b].load(std::memory_order_relaxed);
+                }
+            };
+
+            for (auto& thread : threads)
+            {
+                sum(*thread);
+            }
+            sum(retired);
+
+            if (calls == 0)
+            {
+                continue;
+            }
+
+            // counters are read while other threads may still be recording
+            uint64_t histogramCalls = 0;
+            for (size_t b = 0; b < BucketCount; b++)
+            {
+                histogramCalls += buckets[b];
+            }
+
+            auto percentile = [&](double p) -> uint64_t
+            {
+                uint64_t rank = uint64_t(p * double(histogramCalls) + 0.5);
+                rank = rank < 1 ? 1 : rank;
+
+                uint64_t seen = 0;
+                for (size_t b = 0; b < BucketCount; b++)
+                {
+                    seen += buckets[b];
+                    if (seen >= rank)
+                    {
+                        uint64_t bound = BucketUpperBound(b);
+                        return bound < maxNs ? bound : maxNs;
+                    }
+                }
+                return maxNs;
+            };
+
+            char line[384];
+            std::snprintf(line, sizeof(line),
+                "%s{\"name\":\"%s\",\"count\":%llu,\"mean_ns\":%.1f,\"p50_ns\":%llu,\"p95_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}",
+                first ? "" : ",",
+                names[slot],
+                (unsigned long long)calls,
+                double(totalNs) / double(calls),
+                (unsigned long long)percentile(0.50),
+                (unsigned long long)percentile(0.95),
+                (unsigned long long)percentile(0.99),
+                (unsigned long long)maxNs);
+
+            json += line;
+            first = false;
+        }
+
+        json += "]}";
+        return json;
+    }
+};
+
+// Times the enclosing scope and records it against one entry point.
+class BridgeProfileScope
+{
+private:
+    size_t                                slot;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit BridgeProfileScope(size_t slot)
+        : slot(slot), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    BridgeProfileScope(const BridgeProfileScope&) = delete;
+    BridgeProfileScope& operator=(const BridgeProfileScope&) = delete;
+
+    ~BridgeProfileScope()
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        BridgeProfiler::Shared().Record(slot, uint64_t(ns));
+    }
+};
+
+#define BRIDGE_PROFILE_CALL(entry_point)                                                     \
+    static const size_t bridge_profile_slot = BridgeProfiler::Shared().Register(#entry_point); \
+    BridgeProfileScope bridge_profile_scope(bridge_profile_slot)
+
+#else
+
+#define BRIDGE_PROFILE_CALL(entry_point)
+
+#endif
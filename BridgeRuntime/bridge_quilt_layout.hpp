@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Per-view constants of a quilt, so the render loop walks a table instead of
+// recomputing the view index, inverted row and normalizedView for every view.
+//
+// Views are in quilt order (viewIndex = y * vx + x, y counted from the top). The
+// row is already flipped for glViewport, whose origin is bottom-left:
+//
+//   for (const QuiltViewCell& cell : layout)
+//       glViewport(cell.column * view_width, cell.row * view_height, view_width, view_height);
+
+struct QuiltViewCell
+{
+    unsigned short column;          // x, in views from the left
+    unsigned short row;             // vy - 1 - y, in views from the bottom
+    float          normalizedView;  // viewIndex / (vx * vy - 1), 0.5 for a single view
+};
+
+template<int VX, int VY>
+class QuiltLayout
+{
+    static_assert(VX > 0 && VY > 0, "a quilt needs at least one view");
+
+private:
+    static constexpr std::array<QuiltViewCell, size_t(VX * VY)> MakeCells()
+    {
+        std::array<QuiltViewCell, size_t(VX * VY)> cells = {};
+        for (int y = 0; y < VY; y++)
+        {
+            for (int x = 0; x < VX; x++)
+            {
+                int viewIndex = y * VX + x;
+                cells[viewIndex].column = static_cast<unsigned short>(x);
+                cells[viewIndex].row = static_cast<unsigned short>(VY - 1 - y);
+                cells[viewIndex].normalizedView = VX * VY > 1
+                    ? static_cast<float>(viewIndex) / static_cast<float>(VX * VY - 1)
+                    : 0.5f;
+            }
+        }
+        return cells;
+    }
+
+public:
+    static constexpr int Columns = VX;
+    static constexpr int Rows = VY;
+    static constexpr int Views = VX * VY;
+    static constexpr std::array<QuiltViewCell, size_t(VX * VY)> Cells = MakeCells();
+};
+
+// Cell table for a layout only known at run time, e.g. from BridgeWindowData.
+// Layouts of shipping devices point at a QuiltLayout table; anything else is built
+// once here. Rebuild only when vx or vy change.
+class QuiltLayoutTable
+{
+private:
+    int                        columns = 0;
+    int                        rows = 0;
+    const QuiltViewCell*       cells = nullptr;
+    std::vector<QuiltViewCell> built;
+
+    template<int VX, int VY>
+    bool UseKnown()
+    {
+        if (columns != VX || rows != VY)
+        {
+            return false;
+        }
+        cells = QuiltLayout<VX, VY>::Cells.data();
+        return true;
+    }
+
+public:
+    QuiltLayoutTable() = default;
+
+    QuiltLayoutTable(int vx, int vy)
+    {
+        Reset(vx, vy);
+    }
+
+    // The table points into itself for unknown layouts, so copies rebuild it.
+    QuiltLayoutTable(const QuiltLayoutTable& other)
+    {
+        Reset(other.columns, other.rows);
+    }
+
+    QuiltLayoutTable& operator=(const QuiltLayoutTable& other)
+    {
+        if (this != &other)
+        {
+            Reset(other.columns, other.rows);
+        }
+        return *this;
+    }
+
+    // Returns false, leaving the table empty, for a layout without views.
+    bool Reset(int vx, int vy)
+    {
+        if (cells && vx == columns && vy == rows)
+        {
+            return true;
+        }
+
+        columns = vx > 0 && vy > 0 ? vx : 0;
+        rows = vx > 0 && vy > 0 ? vy : 0;
+        cells = nullptr;
+        built.clear();
+
+        if (columns == 0)
+        {
+            return false;
+        }
+
+        if (UseKnown<5, 9>() || UseKnown<8, 6>() || UseKnown<11, 6>() || UseKnown<7, 7>())
+        {
+            return true;
+        }
+
+        int views = columns * rows;
+        built.resize(size_t(views));
+        for (int y = 0; y < rows; y++)
+        {
+            for (int x = 0; x < columns; x++)
+            {
+                int viewIndex = y * columns + x;
+                built[viewIndex].column = static_cast<unsigned short>(x);
+                built[viewIndex].row = static_cast<unsigned short>(rows - 1 - y);
+                built[viewIndex].normalizedView = views > 1
+                    ? static_cast<float>(viewIndex) / static_cast<float>(views - 1)
+                    : 0.5f;
+            }
+        }
+        cells = built.data();
+        return true;
+    }
+
+    int Columns() const { return columns; }
+    int Rows() const { return rows; }
+    int Views() const { return columns * rows; }
+
+    // True if the table is one of the compile-time QuiltLayout tables.
+    bool IsKnownLayout() const
+    {
+        return cells != nullptr && built.empty();
+    }
+
+    const QuiltViewCell& operator[](int viewIndex) const { return cells[viewIndex]; }
+    const QuiltViewCell* begin() const { return cells; }
+    const QuiltViewCell* end() const { return cells + Views(); }
+};
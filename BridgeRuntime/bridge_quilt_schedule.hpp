@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+
+// Order of the (object, view) draws of a quilt pass.
+//
+// ViewMajor draws every object into one view before moving to the next, so each view
+// repeats every object's program, vertex array and texture binds and per-object
+// uniforms. ObjectMajor binds an object once and draws it into every view, at the
+// price of a viewport and view index change per draw. Which is cheaper depends on how
+// much state the objects share and on what each call costs on the driver at hand;
+// QuiltDrawSchedule::Choose compares the calls both orders issue under the
+// QuiltDrawCosts the caller measured.
+//
+//   QuiltDrawOrder order = QuiltDrawSchedule::Choose(items, objects, views, costs);
+//   QuiltDrawSchedule::ForEach(order, objects, views, [&](int object, int view) { ... });
+
+enum class QuiltDrawOrder
+{
+    ViewMajor,
+    ObjectMajor
+};
+
+// State an object's draw binds. Objects with equal keys share the bind, so a schedule
+// only pays for it when the key changes between consecutive draws.
+struct QuiltDrawItem
+{
+    unsigned int program;
+    unsigned int vertexArray;
+    unsigned int texture;
+};
+
+// Calls a schedule issues once redundant binds are skipped.
+struct QuiltDrawCounts
+{
+    size_t programBinds = 0;
+    size_t vertexArrayBinds = 0;
+    size_t textureBinds = 0;
+    size_t objectChanges = 0;   // per-object uniforms such as the model matrix
+    size_t viewChanges = 0;     // viewport and view index
+    size_t draws = 0;
+};
+
+// CPU cost of each call relative to a draw, as measured on the target driver. The
+// defaults are uncalibrated placeholders that only follow the usual ordering,
+// program changes first; Choose is only as good as the numbers passed to it.
+struct QuiltDrawCosts
+{
+    double programBind = 4.0;
+    double vertexArrayBind = 2.0;
+    double textureBind = 2.0;
+    double objectChange = 1.0;
+    double viewChange = 1.5;
+    double draw = 1.0;
+
+    double Of(const QuiltDrawCounts& counts) const
+    {
+        return programBind * double(counts.programBinds) +
+               vertexArrayBind * double(counts.vertexArrayBinds) +
+               textureBind * double(counts.textureBinds) +
+               objectChange * double(counts.objectChanges) +
+               viewChange * double(counts.viewChanges) +
+               draw * double(counts.draws);
+    }
+};
+
+class QuiltDrawSchedule
+{
+public:
+    // Calls visit(object, view) for every object and view in the given order.
+    template<typename Visit>
+    static void ForEach(QuiltDrawOrder order, int objects, int views, Visit&& visit)
+    {
+        if (order == QuiltDrawOrder::ObjectMajor)
+        {
+            for (int object = 0; object < objects; object++)
+            {
+                for (int view = 0; view < views; view++)
+                {
+                    visit(object, view);
+                }
+            }
+        }
+        else
+        {
+            for (int view = 0; view < views; view++)
+            {
+                for (int object = 0; object < objects; object++)
+                {
+                    visit(object, view);
+                }
+            }
+        }
+    }
+
+    static QuiltDrawCounts Count(QuiltDrawOrder order, const QuiltDrawItem* items, int objects, int views)
+    {
+        QuiltDrawCounts counts;
+        const QuiltDrawItem* last = nullptr;
+        int lastObject = -1;
+        int lastView = -1;
+
+        ForEach(order, objects, views, [&](int object, int view)
+        {
+            const QuiltDrawItem& item = items[object];
+            counts.programBinds += !last || last->program != item.program;
+            counts.vertexArrayBinds += !last || last->vertexArray != item.vertexArray;
+            counts.textureBinds += !last || last->texture != item.texture;
+            counts.objectChanges += object != lastObject;
+            counts.viewChanges += view != lastView;
+            counts.draws++;
+
+            last = &item;
+            lastObject = object;
+            lastView = view;
+        });
+
+        return counts;
+    }
+
+    // The cheaper order under costs; ViewMajor on a tie. Depends only on the items'
+    // keys, the view count and costs, so choose once and again when any changes.
+    static QuiltDrawOrder Choose(const QuiltDrawItem* items, int objects, int views, const QuiltDrawCosts& costs)
+    {
+        double viewMajor = costs.Of(Count(QuiltDrawOrder::ViewMajor, items, objects, views));
+        double objectMajor = costs.Of(Count(QuiltDrawOrder::ObjectMajor, items, objects, views));
+        return objectMajor < viewMajor ? QuiltDrawOrder::ObjectMajor : QuiltDrawOrder::ViewMajor;
+    }
+};
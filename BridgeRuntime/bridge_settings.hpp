@@ -0,0 +1,787 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Reader for Bridge's settings.json.
+//
+// The file is read once into memory and scanned in a single pass. Keys and values
+// are kept as views into that buffer; only the install path that is actually
+// returned gets copied (and unescaped). The parsed document is cached by file
+// modification time and size, so repeated Initialize / SwitchBridgeVersion calls
+// do not touch the file again unless Bridge rewrote it.
+
+// major.minor.build with an optional "-postfix". Compares numerically, so 2.10.0 is
+// newer than 2.6.0, and a postfixed build sorts before the plain release. Further
+// numeric components, as in 2.6.2.1, are accepted and ignored.
+struct BridgeSemanticVersion
+{
+    unsigned long    major = 0;
+    unsigned long    minor = 0;
+    unsigned long    build = 0;
+    std::string_view postfix;
+    bool             valid = false;
+
+    static BridgeSemanticVersion Parse(std::string_view text)
+    {
+        BridgeSemanticVersion version;
+        unsigned long* parts[] = { &version.major, &version.minor, &version.build };
+
+        size_t pos = 0;
+        for (int i = 0; i < 3; i++)
+        {
+            size_t digits = 0;
+            unsigned long value = 0;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+            {
+                value = value * 10 + (unsigned long)(text[pos] - '0');
+                pos++;
+                digits++;
+            }
+
+            if (digits == 0)
+            {
+                return BridgeSemanticVersion();
+            }
+
+            *parts[i] = value;
+
+            if (i < 2)
+            {
+                // "2.6" is accepted as 2.6.0
+                if (pos == text.size())
+                {
+                    break;
+                }
+
+                if (text[pos] != '.')
+                {
+                    return BridgeSemanticVersion();
+                }
+
+                pos++;
+            }
+        }
+
+        while (pos + 1 < text.size() && text[pos] == '.' && text[pos + 1] >= '0' && text[pos + 1] <= '9')
+        {
+            pos++;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+            {
+                pos++;
+            }
+        }
+
+        if (pos < text.size())
+        {
+            if (text[pos] != '-' && text[pos] != '+')
+            {
+                return BridgeSemanticVersion();
+            }
+
+            version.postfix = text.substr(pos + 1);
+        }
+
+        version.valid = true;
+        return version;
+    }
+
+    int Compare(const BridgeSemanticVersion& other) const
+    {
+        if (major != other.major) return major < other.major ? -1 : 1;
+        if (minor != other.minor) return minor < other.minor ? -1 : 1;
+        if (build != other.build) return build < other.build ? -1 : 1;
+
+        if (postfix.empty() != other.postfix.empty())
+        {
+            return postfix.empty() ? 1 : -1;
+        }
+
+        int postfixOrder = postfix.compare(other.postfix);
+        return postfixOrder < 0 ? -1 : (postfixOrder > 0 ? 1 : 0);
+    }
+
+    bool operator<(const BridgeSemanticVersion& other) const  { return Compare(other) < 0; }
+    bool operator==(const BridgeSemanticVersion& other) const { return Compare(other) == 0; }
+};
+
+class BridgeSettingsDocument
+{
+public:
+    struct InstallLocation
+    {
+        std::string_view version;   // raw JSON string contents, still escaped
+        std::string_view path;      // raw JSON string contents, still escaped
+    };
+
+private:
+    std::string                  text;
+    std::vector<InstallLocation> installLocations;
+
+    // Position of the top-level object's opening brace and of the
+    // enable_utilization_telemetry value, as offsets into text.
+    size_t                       objectBegin = std::string::npos;
+    size_t                       telemetryBegin = std::string::npos;
+    size_t                       telemetryEnd = std::string::npos;
+    bool                         parsed = false;
+
+    const char*                  cur = nullptr;
+    const char*                  end = nullptr;
+
+    static const int             MaxDepth = 64;
+
+    void SkipWhitespace()
+    {
+        while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r'))
+        {
+            cur++;
+        }
+    }
+
+    bool Consume(char c)
+    {
+        SkipWhitespace();
+        if (cur < end && *cur == c)
+        {
+            cur++;
+            return true;
+        }
+        return false;
+    }
+
+    bool ScanString(std::string_view& out)
+    {
+        if (!Consume('"'))
+        {
+            return false;
+        }
+
+        const char* begin = cur;
+        while (cur < end && *cur != '"')
+        {
+            // skip the escaped character, it may be a quote
+            cur += (*cur == '\\' && cur + 1 < end) ? 2 : 1;
+        }
+
+        if (cur >= end)
+        {
+            return false;
+        }
+
+        out = std::string_view(begin, size_t(cur - begin));
+        cur++;
+        return true;
+    }
+
+    bool SkipValue(int depth)
+    {
+        if (depth > MaxDepth)
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (cur >= end)
+        {
+            return false;
+        }
+
+        std::string_view ignored;
+        switch (*cur)
+        {
+        case '"':
+            return ScanString(ignored);
+
+        case '{':
+            cur++;
+            if (Consume('}'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!ScanString(ignored) || !Consume(':') || !SkipValue(depth + 1))
+                {
+                    return false;
+                }
+            } while (Consume(','));
+            return Consume('}');
+
+        case '[':
+            cur++;
+            if (Consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!SkipValue(depth + 1))
+                {
+                    return false;
+                }
+            } while (Consume(','));
+            return Consume(']');
+
+        default:
+            // number, true, false or null
+            {
+                const char* begin = cur;
+                while (cur < end && *cur != ',' && *cur != '}' && *cur != ']' &&
+                       *cur != ' ' && *cur != '\t' && *cur != '\n' && *cur != '\r')
+                {
+                    cur++;
+                }
+                return cur != begin;
+            }
+        }
+    }
+
+    bool ScanInstallLocation()
+    {
+        InstallLocation location;
+        bool hasPath = false;
+        bool hasVersion = false;
+
+        if (!Consume('{'))
+        {
+            return SkipValue(2);
+        }
+
+        if (Consume('}'))
+        {
+            return true;
+        }
+
+        do
+        {
+            std::string_view key;
+            if (!ScanString(key) || !Consume(':'))
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (key == "path" && cur < end && *cur == '"')
+            {
+                hasPath = ScanString(location.path);
+            }
+            else if (key == "version" && cur < end && *cur == '"')
+            {
+                hasVersion = ScanString(location.version);
+            }
+            else if (!SkipValue(3))
+            {
+                return false;
+            }
+        } while (Consume(','));
+
+        if (hasPath && hasVersion)
+        {
+            installLocations.push_back(location);
+        }
+
+        return Consume('}');
+    }
+
+    bool ScanInstallLocations()
+    {
+        SkipWhitespace();
+        if (cur >= end || *cur != '[')
+        {
+            return SkipValue(1);
+        }
+
+        cur++;
+        if (Consume(']'))
+        {
+            return true;
+        }
+
+        do
+        {
+            if (!ScanInstallLocation())
+            {
+                return false;
+            }
+        } while (Consume(','));
+
+        return Consume(']');
+    }
+
+public:
+    BridgeSettingsDocument() = default;
+    BridgeSettingsDocument(const BridgeSettingsDocument&) = delete;
+    BridgeSettingsDocument& operator=(const BridgeSettingsDocument&) = delete;
+
+    // Takes ownership of the file contents and scans them. Returns false if the
+    // text is not a JSON object; whatever was recognized before the error is kept,
+    // and Parsed() reports the result.
+    bool Parse(std::string contents)
+    {
+        text = std::move(contents);
+        installLocations.clear();
+        objectBegin = telemetryBegin = telemetryEnd = std::string::npos;
+        parsed = ScanDocument();
+        return parsed;
+    }
+
+    // False if the last Parse stopped at an error, so offsets may be missing.
+    bool Parsed() const
+    {
+        return parsed;
+    }
+
+private:
+    bool ScanDocument()
+    {
+
+        cur = text.data();
+        end = text.data() + text.size();
+
+        // UTF-8 byte order mark
+        if (text.size() >= 3 && text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+        {
+            cur += 3;
+        }
+
+        SkipWhitespace();
+        if (cur >= end || *cur != '{')
+        {
+            return false;
+        }
+
+        objectBegin = size_t(cur - text.data());
+        cur++;
+
+        if (Consume('}'))
+        {
+            return true;
+        }
+
+        do
+        {
+            std::string_view key;
+            if (!ScanString(key) || !Consume(':'))
+            {
+                return false;
+            }
+
+            if (key == "install_locations")
+            {
+                if (!ScanInstallLocations())
+                {
+                    return false;
+                }
+            }
+            else if (key == "enable_utilization_telemetry")
+            {
+                SkipWhitespace();
+                size_t begin = size_t(cur - text.data());
+                if (!SkipValue(1))
+                {
+                    return false;
+                }
+                telemetryBegin = begin;
+                telemetryEnd = size_t(cur - text.data());
+            }
+            else if (!SkipValue(1))
+            {
+                return false;
+            }
+        } while (Consume(','));
+
+        return Consume('}');
+    }
+
+public:
+    const std::string& Text() const
+    {
+        return text;
+    }
+
+    const std::vector<InstallLocation>& InstallLocations() const
+    {
+        return installLocations;
+    }
+
+    size_t ObjectBegin() const
+    {
+        return objectBegin;
+    }
+
+    bool HasTelemetrySetting() const
+    {
+        return telemetryBegin != std::string::npos;
+    }
+
+    // The raw value, e.g. true or "false" (quoted values are what older Bridge builds wrote).
+    std::string_view TelemetryValue() const
+    {
+        if (!HasTelemetrySetting())
+        {
+            return std::string_view();
+        }
+        return std::string_view(text).substr(telemetryBegin, telemetryEnd - telemetryBegin);
+    }
+
+    size_t TelemetryBegin() const { return telemetryBegin; }
+    size_t TelemetryEnd() const   { return telemetryEnd; }
+
+    // Decodes JSON string escapes. Install paths on Windows always contain "\\".
+    static std::string Unescape(std::string_view raw)
+    {
+        std::string out;
+        out.reserve(raw.size());
+
+        for (size_t i = 0; i < raw.size(); i++)
+        {
+            char c = raw[i];
+            if (c != '\\' || i + 1 >= raw.size())
+            {
+                out.push_back(c);
+                continue;
+            }
+
+            c = raw[++i];
+            switch (c)
+            {
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u':
+                {
+                    uint32_t code = 0;
+                    if (!ReadHex4(raw, i + 1, code))
+                    {
+                        out.push_back('u');
+                        break;
+                    }
+                    i += 4;
+
+                    uint32_t low = 0;
+                    if (code >= 0xD800 && code <= 0xDBFF && i + 6 < raw.size() &&
+                        raw[i + 1] == '\\' && raw[i + 2] == 'u' && ReadHex4(raw, i + 3, low) &&
+                        low >= 0xDC00 && low <= 0xDFFF)
+                    {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+
+                    AppendUtf8(out, code);
+                }
+                break;
+            default:
+                // \" \\ \/
+                out.push_back(c);
+                break;
+            }
+        }
+
+        return out;
+    }
+
+private:
+    static bool ReadHex4(std::string_view raw, size_t pos, uint32_t& value)
+    {
+        if (pos + 4 > raw.size())
+        {
+            return false;
+        }
+
+        value = 0;
+        for (size_t i = pos; i < pos + 4; i++)
+        {
+            char c = raw[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9')      value |= uint32_t(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= uint32_t(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= uint32_t(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    static void AppendUtf8(std::string& out, uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            out.push_back(char(code));
+        }
+        else if (code < 0x800)
+        {
+            out.push_back(char(0xC0 | (code >> 6)));
+            out.push_back(char(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            out.push_back(char(0xE0 | (code >> 12)));
+            out.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(char(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            out.push_back(char(0xF0 | (code >> 18)));
+            out.push_back(char(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(char(0x80 | (code & 0x3F)));
+        }
+    }
+};
+
+// Writes contents to a temporary file next to path and renames it over path, so a
+// reader sees either the old file or the complete new one.
+inline bool BridgeWriteFileAtomically(const std::filesystem::path& path, const std::string& contents)
+{
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        out.write(contents.data(), std::streamsize(contents.size()));
+        out.flush();
+        if (!out)
+        {
+            out.close();
+            std::error_code ignored;
+            std::filesystem::remove(temp, ignored);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    return true;
+}
+
+// Process-wide cache of the parsed settings file. All Controllers share it, so a
+// second Initialize only pays a stat() of settings.json.
+class BridgeSettingsCache
+{
+private:
+    std::mutex                                    mutex;
+    std::filesystem::path                         cachedPath;
+    std::filesystem::file_time_type               cachedTime;
+    uintmax_t                                     cachedSize = 0;
+    std::shared_ptr<const BridgeSettingsDocument> cachedDocument;
+
+    // last install location resolution against cachedDocument
+    std::string                                   resolvedRequest;
+    std::string                                   resolvedMinimum;
+    std::string                                   resolvedPath;
+    bool                                          hasResolved = false;
+
+    // Returns the cached document, re-reading the file if its mtime or size changed.
+    // Returns null if the file does not exist. Call with mutex held.
+    std::shared_ptr<const BridgeSettingsDocument> LoadLocked(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, ec);
+        if (ec)
+        {
+            cachedDocument = nullptr;
+            hasResolved = false;
+            return nullptr;
+        }
+
+        // A directory or special file has no size; treat it like a missing file.
+        uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec)
+        {
+            cachedDocument = nullptr;
+            hasResolved = false;
+            return nullptr;
+        }
+
+        if (cachedDocument && path == cachedPath && time == cachedTime && size == cachedSize)
+        {
+            return cachedDocument;
+        }
+
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            cachedDocument = nullptr;
+            hasResolved = false;
+            return nullptr;
+        }
+
+        std::string contents;
+        contents.resize(size_t(size));
+        in.read(&contents[0], std::streamsize(contents.size()));
+        contents.resize(size_t(in.gcount()));
+
+        auto document = std::make_shared<BridgeSettingsDocument>();
+        document->Parse(std::move(contents));
+
+        cachedPath = path;
+        cachedTime = time;
+        cachedSize = size;
+        cachedDocument = std::move(document);
+        hasResolved = false;
+        return cachedDocument;
+    }
+
+    static bool IsMissing(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        std::filesystem::file_status status = std::filesystem::symlink_status(path, ec);
+        return status.type() == std::filesystem::file_type::not_found;
+    }
+
+    static std::string Resolve(const BridgeSettingsDocument& document, std::string_view requestedVersion, std::string_view minimumVersion)
+    {
+        const BridgeSemanticVersion minimum = BridgeSemanticVersion::Parse(minimumVersion);
+        const BridgeSemanticVersion requested = BridgeSemanticVersion::Parse(requestedVersion);
+
+        const BridgeSettingsDocument::InstallLocation* exact = nullptr;
+        const BridgeSettingsDocument::InstallLocation* highest = nullptr;
+        BridgeSemanticVersion highestVersion;
+
+        for (const auto& location : document.InstallLocations())
+        {
+            BridgeSemanticVersion version = BridgeSemanticVersion::Parse(location.version);
+
+            // Skip versions below the minimum allowed version
+            if (!version.valid || (minimum.valid && version < minimum))
+            {
+                continue;
+            }
+
+            // later entries win, matching how Bridge appends new installs
+            if (location.version == requestedVersion)
+            {
+                exact = &location;
+            }
+
+            // Track the highest version with the same major version number
+            if (requested.valid && version.major == requested.major &&
+                (!highest || !(version < highestVersion)))
+            {
+                highest = &location;
+                highestVersion = version;
+            }
+        }
+
+        if (exact)
+        {
+            return BridgeSettingsDocument::Unescape(exact->path);
+        }
+
+        if (highest)
+        {
+            return BridgeSettingsDocument::Unescape(highest->path);
+        }
+
+        return std::string();
+    }
+
+public:
+    static BridgeSettingsCache& Shared()
+    {
+        static BridgeSettingsCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const BridgeSettingsDocument> Load(const std::filesystem::path& path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return LoadLocked(path);
+    }
+
+    // Install path (UTF-8) of requestedVersion, or of the highest installed version with
+    // the same major number. Versions below minimumVersion are ignored. Empty if none match.
+    std::string ResolveInstallLocation(const std::filesystem::path& path, std::string_view requestedVersion, std::string_view minimumVersion)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::shared_ptr<const BridgeSettingsDocument> document = LoadLocked(path);
+        if (!document)
+        {
+            return std::string();
+        }
+
+        if (!hasResolved || resolvedRequest != requestedVersion || resolvedMinimum != minimumVersion)
+        {
+            resolvedPath = Resolve(*document, requestedVersion, minimumVersion);
+            resolvedRequest = std::string(requestedVersion);
+            resolvedMinimum = std::string(minimumVersion);
+            hasResolved = true;
+        }
+
+        return resolvedPath;
+    }
+
+    // Sets enable_utilization_telemetry. The file is only rewritten when the stored value
+    // differs, and then via a temporary file and rename so Bridge never reads a partial file.
+    // A file that cannot be read or parsed is left alone and false returned; a new file
+    // is only written when none exists.
+    bool SetTelemetryEnabled(const std::filesystem::path& path, bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const std::string_view newVal = enabled ? "true" : "false";
+        std::shared_ptr<const BridgeSettingsDocument> document = LoadLocked(path);
+
+        if (document ? !document->Parsed() : !IsMissing(path))
+        {
+            return false;
+        }
+
+        std::string json;
+        if (document && document->HasTelemetrySetting())                      // key exists patch value
+        {
+            std::string_view current = document->TelemetryValue();
+            if (current.size() >= 2 && current.front() == '"' && current.back() == '"')
+            {
+                current = current.substr(1, current.size() - 2);
+            }
+
+            if (current == newVal)
+            {
+                return true;
+            }
+
+            json = document->Text();
+            json.replace(document->TelemetryBegin(), document->TelemetryEnd() - document->TelemetryBegin(), newVal);
+        }
+        else if (document)                                                     // key missing insert
+        {
+            json = document->Text();
+
+            size_t afterBrace = document->ObjectBegin() + 1;
+            size_t next = json.find_first_not_of(" \t\r\n", afterBrace);
+            bool empty = next == std::string::npos || json[next] == '}';
+
+            std::string ins = "\n    \"enable_utilization_telemetry\": " + std::string(newVal) + (empty ? "\n" : ",");
+            json.insert(afterBrace, ins);
+        }
+        else
+        {
+            json = "{\n    \"enable_utilization_telemetry\": " + std::string(newVal) + "\n}\n";
+        }
+
+        cachedDocument = nullptr;
+        hasResolved = false;
+        return BridgeWriteFileAtomically(path, json);
+    }
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Small worker pool behind the Controller's *Async calls.
+//
+// The queue is bounded: Submit rejects work instead of letting a burst of
+// captures pile up behind a slow conversion. Rejected and cancelled tasks
+// complete their future with BridgeTaskCancelled, so get() never blocks forever.
+
+class BridgeTaskCancelled : public std::runtime_error
+{
+public:
+    explicit BridgeTaskCancelled(const char* reason)
+        : std::runtime_error(reason)
+    {
+    }
+};
+
+// Cancels a queued task. A task that is already running inside Bridge cannot be
+// interrupted and will complete normally.
+class BridgeCancelToken
+{
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+
+public:
+    void Cancel()
+    {
+        cancelled->store(true, std::memory_order_relaxed);
+    }
+
+    bool IsCancelled() const
+    {
+        return cancelled->load(std::memory_order_relaxed);
+    }
+};
+
+class BridgeTaskPool
+{
+private:
+    // Called with run == false when the task is dropped without running.
+    using Task = std::function<void(bool run)>;
+
+    std::mutex               mutex;
+    std::condition_variable  workAvailable;
+    std::condition_variable  idle;
+    std::deque<Task>         queue;
+    std::vector<std::thread> workers;
+    size_t                   maxQueued = 0;
+    size_t                   running = 0;
+    bool                     stopping = false;
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        for (;;)
+        {
+            workAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+            {
+                return;
+            }
+
+            Task task = std::move(queue.front());
+            queue.pop_front();
+            running++;
+
+            lock.unlock();
+            task(true);
+            lock.lock();
+
+            running--;
+            if (running == 0 && queue.empty())
+            {
+                idle.notify_all();
+            }
+        }
+    }
+
+    template<typename R>
+    static std::future<R> Rejected(const char* reason)
+    {
+        std::promise<R> promise;
+        promise.set_exception(std::make_exception_ptr(BridgeTaskCancelled(reason)));
+        return promise.get_future();
+    }
+
+public:
+    BridgeTaskPool(unsigned threadCount, size_t queueDepth)
+        : maxQueued(queueDepth > 0 ? queueDepth : 1)
+    {
+        threadCount = threadCount > 0 ? threadCount : 1;
+        for (unsigned i = 0; i < threadCount; i++)
+        {
+            workers.emplace_back(&BridgeTaskPool::Run, this);
+        }
+    }
+
+    BridgeTaskPool(const BridgeTaskPool&) = delete;
+    BridgeTaskPool& operator=(const BridgeTaskPool&) = delete;
+
+    ~BridgeTaskPool()
+    {
+        CancelPending();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Queues fn and returns its result as a future. If the queue is full, or the
+    // token is cancelled before a worker picks the task up, the future holds
+    // BridgeTaskCancelled instead.
+    template<typename Fn>
+    auto Submit(Fn fn, BridgeCancelToken token = BridgeCancelToken()) -> std::future<decltype(fn())>
+    {
+        using R = decltype(fn());
+
+        auto promise = std::make_shared<std::promise<R>>();
+        std::future<R> result = promise->get_future();
+
+        Task task = [promise, fn = std::move(fn), token](bool run) mutable
+        {
+            if (!run || token.IsCancelled())
+            {
+                promise->set_exception(std::make_exception_ptr(BridgeTaskCancelled("bridge task cancelled")));
+                return;
+            }
+
+            try
+            {
+                if constexpr (std::is_void<R>::value)
+                {
+                    fn();
+                    promise->set_value();
+                }
+                else
+                {
+                    promise->set_value(fn());
+                }
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping || queue.size() >= maxQueued)
+            {
+                return Rejected<R>("bridge task queue is full");
+            }
+
+            queue.push_back(std::move(task));
+        }
+
+        workAvailable.notify_one();
+        return result;
+    }
+
+    // Drops every task that has not started yet.
+    void CancelPending()
+    {
+        std::deque<Task> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            dropped.swap(queue);
+            if (running == 0)
+            {
+                idle.notify_all();
+            }
+        }
+
+        for (auto& task : dropped)
+        {
+            task(false);
+        }
+    }
+
+    // Blocks until the queue is empty and no task is running.
+    void WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return running == 0 && queue.empty(); });
+    }
+
+    size_t Pending()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.size();
+    }
+};
@@ -1,7 +1,19 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include "bridge.h"
+#include "bridge_settings.hpp"
+#include "bridge_tasks.hpp"
+#include "bridge_instrumentation.hpp"
 
 #ifdef _WIN32
 #define INTEROP_EXPORT __declspec(dllexport)
@@ -60,6 +72,36 @@ struct DisplayInfo {
     WindowPos           window_position;
 };
 
+// Immutable view of every connected display. A snapshot is never modified once it
+// has been published; the Controller swaps in a new one with a higher generation
+// when the set of connected displays changes, so callers can hold on to it and
+// compare generations instead of re-querying Bridge.
+struct DisplaySnapshot {
+    uint64_t                 generation = 0;
+    std::vector<DisplayInfo> displays;
+    bool                     from_disk_cache = false;   // ids are live, the rest is from LoadCachedDisplaySnapshot
+
+    const DisplayInfo* FindBySerial(const std::wstring& serial) const {
+        for (const auto& display : displays) {
+            if (display.serial == serial) {
+                return &display;
+            }
+        }
+        return nullptr;
+    }
+
+    const DisplayInfo* FindById(unsigned long display_id) const {
+        for (const auto& display : displays) {
+            if (display.display_id == display_id) {
+                return &display;
+            }
+        }
+        return nullptr;
+    }
+};
+
+#include "bridge_display_cache.hpp"
+
 struct BridgeWindowData {
     WINDOW_HANDLE   wnd = 0;
     unsigned long   display_index = 0;
@@ -93,71 +135,99 @@ struct BridgeWindowData {
 // You may also pass in a specific version, if that version is installed it will be used.
 // Otherwise it will attempt to locate the closest matching version.
 // You may also leave the version blank and pass in a full path to the folder where bridge is installed.
+
+// Threading: once Initialize has returned, every wrapper may be called from any
+// number of threads at once. The wrappers read the bound function table without
+// locking, so a render thread is never held up by metadata queries on another
+// thread. Initialize, Uninitialize and SwitchBridgeVersion are serialized against
+// each other, but they load and unload the runtime itself, so no other thread may
+// be inside a wrapper while they run.
 class Controller
 {
 protected:
-    class DynamicLibraryLoader
+    // Owns the handle to the Bridge runtime library. The runtime is opened once per
+    // InitializeWithPath and released again by Uninitialize, so switching Bridge
+    // versions or re-initializing never leaks a handle.
+    class RuntimeLibrary
     {
     private:
-        std::map<std::string, void*> functionCache;
+#ifdef _WIN32
+        HMODULE handle = nullptr;
+#else
+        void* handle = nullptr;
+#endif
 
     public:
-#ifdef _WIN32
-        template<typename T>
-        T LoadFunction(const std::wstring& path, const std::string& functionName)
+        RuntimeLibrary() = default;
+        RuntimeLibrary(const RuntimeLibrary&) = delete;
+        RuntimeLibrary& operator=(const RuntimeLibrary&) = delete;
+
+        ~RuntimeLibrary()
         {
-            auto key = std::string(path.begin(), path.end()) + functionName;
-            auto it = functionCache.find(key);
-            if (it != functionCache.end())
-            {
-                return reinterpret_cast<T>(it->second);
-            }
+            Close();
+        }
 
-            HMODULE handle = LoadLibraryW(path.c_str());
-            if (!handle)
-            {
-                return nullptr;
-            }
+#ifdef _WIN32
+        // LoadLibraryW always resolves imports at load time, so bindNow has no effect here.
+        bool Open(const std::wstring& path, bool bindNow)
+        {
+            Close();
+            handle = LoadLibraryW(path.c_str());
+            return handle != nullptr;
+        }
+#else
+        // bindNow opens with RTLD_NOW so every relocation in the runtime is resolved
+        // up front instead of on the first call of each entry point.
+        bool Open(const std::string& path, bool bindNow)
+        {
+            Close();
+            handle = dlopen(path.c_str(), bindNow ? RTLD_NOW : RTLD_LAZY);
+            return handle != nullptr;
+        }
+#endif
 
-            FARPROC funcPtr = GetProcAddress(handle, functionName.c_str());
-            if (!funcPtr)
+        void Close()
+        {
+            if (handle)
             {
-                return nullptr;
+#ifdef _WIN32
+                FreeLibrary(handle);
+#else
+                dlclose(handle);
+#endif
+                handle = nullptr;
             }
+        }
 
-            functionCache[key] = funcPtr;
-            return reinterpret_cast<T>(funcPtr);
+        bool IsOpen() const
+        {
+            return handle != nullptr;
         }
-#else
+
         template<typename T>
-        T LoadFunction(const std::string& path, const std::string& functionName)
+        T LoadFunction(const char* functionName) const
         {
-            auto key = path + functionName;
-            auto it = functionCache.find(key);
-            if (it != functionCache.end())
-            {
-                return reinterpret_cast<T>(it->second);
-            }
-
-            void* handle = dlopen(path.c_str(), RTLD_LAZY);
             if (!handle)
             {
                 return nullptr;
             }
 
-            void* funcPtr = dlsym(handle, functionName.c_str());
-            if (!funcPtr)
-            {
-                return nullptr;
-            }
-
-            functionCache[key] = funcPtr;
-            return reinterpret_cast<T>(funcPtr);
-        }
+#ifdef _WIN32
+            return reinterpret_cast<T>(GetProcAddress(handle, functionName));
+#else
+            return reinterpret_cast<T>(dlsym(handle, functionName));
 #endif
+        }
     };
 
-    DynamicLibraryLoader _DynamicLibraryLoader;
+    // Serializes Initialize / Uninitialize / SwitchBridgeVersion and everything they
+    // touch (_library, _libraryPath, _bindNow, _bridge). Recursive because
+    // SwitchBridgeVersion calls back into Initialize.
+    std::recursive_mutex _lifecycleMutex;
+
+    RuntimeLibrary _library;
+    bool _bindNow = false;
+    std::atomic<bool> _initialized{ false };
 
 #ifdef _WIN32
     std::wstring _libraryPath;
@@ -165,100 +235,263 @@ protected:
     std::string _libraryPath;
 #endif
 
-    // ---------------------------------------------------------------- telemetry --
-    // NOTE: These functions must be called before initializing bridge
-private:
-#ifdef _WIN32
-    bool ApplyTrackingSetting(bool disable)
+    // Typed entry points for every bridge.h export. These are resolved once by
+    // BindFunctions when the runtime is loaded, so each wrapper below is a single
+    // indirect call with no string building or map lookup. Entry points the
+    // runtime does not export (DX off Windows, Metal off macOS) stay nullptr.
+    struct BridgeFunctions
     {
-        const std::wstring settingsPath = SettingsPath();
-        const std::wstring newVal = disable ? L"false" : L"true";
-
-        std::wifstream in(settingsPath);
-        std::wstringstream buf;
-        if (in) buf << in.rdbuf();
-        std::wstring json = buf.str();
-        in.close();
+#ifdef _WIN32
+        bool (*initialize_bridge)(const wchar_t*) = nullptr;
+        bool (*save_texture_to_file_gl)(WINDOW_HANDLE, wchar_t*, unsigned long long, PixelFormats, unsigned long, unsigned long) = nullptr;
+        bool (*save_image_to_file)(WINDOW_HANDLE, wchar_t*, void*, PixelFormats, unsigned long, unsigned long) = nullptr;
+#else
+        bool (*initialize_bridge)(const char*) = nullptr;
+        bool (*save_texture_to_file_gl)(WINDOW_HANDLE, char*, unsigned long long, PixelFormats, unsigned long, unsigned long) = nullptr;
+        bool (*save_image_to_file)(WINDOW_HANDLE, char*, void*, PixelFormats, unsigned long, unsigned long) = nullptr;
+#endif
+        bool (*uninitialize_bridge)() = nullptr;
+        bool (*get_bridge_version)(unsigned long*, unsigned long*, unsigned long*, int*, wchar_t*) = nullptr;
+        bool (*instance_window_gl)(WINDOW_HANDLE*, unsigned long) = nullptr;
+        bool (*instance_offscreen_window_gl)(WINDOW_HANDLE*, unsigned long) = nullptr;
+        bool (*get_offscreen_window_texture_gl)(WINDOW_HANDLE, unsigned long long*, PixelFormats*, unsigned long*, unsigned long*) = nullptr;
+        bool (*quiltify_rgbd)(WINDOW_HANDLE, unsigned long, unsigned long, unsigned long, float, float, float, float, float, float, unsigned long, unsigned long, unsigned long, float, float, float, const wchar_t*, const wchar_t*) = nullptr;
+        bool (*get_window_dimensions)(WINDOW_HANDLE, unsigned long*, unsigned long*) = nullptr;
+        bool (*get_max_texture_size)(WINDOW_HANDLE, unsigned long*) = nullptr;
+        bool (*set_interop_quilt_texture_gl)(WINDOW_HANDLE, unsigned long long, PixelFormats, unsigned long, unsigned long, unsigned long, unsigned long, float, float) = nullptr;
+        bool (*draw_interop_quilt_texture_gl)(WINDOW_HANDLE, unsigned long long, PixelFormats, unsigned long, unsigned long, unsigned long, unsigned long, float, float) = nullptr;
+        bool (*draw_interop_rgbd_texture_gl)(WINDOW_HANDLE, unsigned long, PixelFormats, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, float, float, float, float, int) = nullptr;
+        bool (*show_window)(WINDOW_HANDLE, bool) = nullptr;
+        bool (*device_from_resource_dx)(IUnknown*, IUnknown**) = nullptr;
+        bool (*release_device_dx)(IUnknown*) = nullptr;
+        bool (*instance_window_dx)(IUnknown*, WINDOW_HANDLE*, unsigned long) = nullptr;
+        bool (*register_texture_dx)(WINDOW_HANDLE, IUnknown*) = nullptr;
+        bool (*unregister_texture_dx)(WINDOW_HANDLE, IUnknown*) = nullptr;
+        bool (*save_texture_to_file_dx)(WINDOW_HANDLE, wchar_t*, IUnknown*) = nullptr;
+        bool (*draw_interop_quilt_texture_dx)(WINDOW_HANDLE, IUnknown*, unsigned long, unsigned long, float, float) = nullptr;
+        bool (*draw_interop_rgbd_texture_dx)(WINDOW_HANDLE, IUnknown*, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, float, float, float, float, int) = nullptr;
+        bool (*create_texture_dx)(WINDOW_HANDLE, unsigned long, unsigned long, IUnknown**) = nullptr;
+        bool (*release_texture_dx)(WINDOW_HANDLE, IUnknown*) = nullptr;
+        bool (*copy_texture_dx)(WINDOW_HANDLE, IUnknown*, IUnknown*) = nullptr;
+        bool (*get_offscreen_window_texture_dx)(WINDOW_HANDLE, IUnknown**) = nullptr;
+        bool (*instance_offscreen_window_dx)(IUnknown*, WINDOW_HANDLE*, unsigned long) = nullptr;
+        bool (*instance_window_metal)(void*, WINDOW_HANDLE*, unsigned long) = nullptr;
+        bool (*create_metal_texture_with_iosurface)(WINDOW_HANDLE, void*, void**) = nullptr;
+        bool (*copy_metal_texture)(WINDOW_HANDLE, void*, void*) = nullptr;
+        bool (*release_metal_texture)(WINDOW_HANDLE, void*) = nullptr;
+        bool (*save_metal_texture_to_file)(WINDOW_HANDLE, char*, void*, PixelFormats, unsigned long, unsigned long) = nullptr;
+        bool (*draw_interop_quilt_texture_metal)(WINDOW_HANDLE, void*, unsigned long, unsigned long, float, float) = nullptr;
+        bool (*instance_offscreen_window_metal)(void*, WINDOW_HANDLE*, unsigned long) = nullptr;
+        bool (*get_offscreen_window_texture_metal)(WINDOW_HANDLE, void**) = nullptr;
+        bool (*get_calibration)(WINDOW_HANDLE, float*, float*, float*, int*, int*, float*, float*, int*, float*, float*, int*, int*, CalibrationSubpixelCell*) = nullptr;
+        bool (*get_device_name)(WINDOW_HANDLE, int*, wchar_t*) = nullptr;
+        bool (*get_device_serial)(WINDOW_HANDLE, int*, wchar_t*) = nullptr;
+        bool (*get_default_quilt_settings)(WINDOW_HANDLE, float*, int*, int*, int*, int*) = nullptr;
+        bool (*get_displays)(int*, unsigned long*) = nullptr;
+        bool (*get_device_name_for_display)(unsigned long, int*, wchar_t*) = nullptr;
+        bool (*get_device_serial_for_display)(unsigned long, int*, wchar_t*) = nullptr;
+        bool (*get_dimensions_for_display)(unsigned long, unsigned long*, unsigned long*) = nullptr;
+        bool (*get_device_type_for_display)(unsigned long, int*) = nullptr;
+        bool (*get_calibration_for_display)(unsigned long, float*, float*, float*, int*, int*, float*, float*, int*, float*, float*, int*, int*, CalibrationSubpixelCell*) = nullptr;
+        bool (*get_invview_for_display)(unsigned long, int*) = nullptr;
+        bool (*get_ri_for_display)(unsigned long, int*) = nullptr;
+        bool (*get_bi_for_display)(unsigned long, int*) = nullptr;
+        bool (*get_tilt_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_displayaspect_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_fringe_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_subp_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_viewcone_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_display_for_window)(WINDOW_HANDLE, unsigned long*) = nullptr;
+        bool (*get_default_quilt_settings_for_display)(unsigned long, float*, int*, int*, int*, int*) = nullptr;
+        bool (*get_device_type)(WINDOW_HANDLE, int*) = nullptr;
+        bool (*get_pitch_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_center_for_display)(unsigned long, float*) = nullptr;
+        bool (*get_viewcone)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_invview)(WINDOW_HANDLE, int*) = nullptr;
+        bool (*get_ri)(WINDOW_HANDLE, int*) = nullptr;
+        bool (*get_bi)(WINDOW_HANDLE, int*) = nullptr;
+        bool (*get_tilt)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_displayaspect)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_fringe)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_subp)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_pitch)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_center)(WINDOW_HANDLE, float*) = nullptr;
+        bool (*get_window_position)(WINDOW_HANDLE, long*, long*) = nullptr;
+        bool (*get_window_position_for_display)(unsigned long, long*, long*) = nullptr;
+    };
 
-        const std::wstring key = L"\"enable_utilization_telemetry\"";
-        bool changed = false;
+    // _bridge is only written while unpublished. The wrappers read it through
+    // _functions, which points at _bridge once the runtime is initialized, so the
+    // per-call path is one acquire load and never takes a lock.
+    BridgeFunctions _bridge;
+    std::atomic<const BridgeFunctions*> _functions{ nullptr };
 
-        size_t k = json.find(key);
-        if (k != std::wstring::npos)                                           // key exists patch value
-        {
-            size_t colon = json.find(L":", k + key.length());
-            size_t v0 = json.find_first_of(L"\"tf", colon + 1);
-            size_t v1 = json.find_first_of(L",}\n\r", v0);
-            if (v0 != std::wstring::npos && v1 != std::wstring::npos &&
-                json.substr(v0, v1 - v0).find(newVal) == std::wstring::npos)
-            {
-                json.replace(v0, v1 - v0, newVal);
-                changed = true;
-            }
-        }
-        else                                                                   // key missing insert
-        {
-            size_t brace = json.find_last_of(L'}');
-            std::wstring ins = L"\n    \"enable_utilization_telemetry\": " + newVal + L",\n";
-            if (brace != std::wstring::npos) json.insert(brace, ins);
-            else json = L"{\n    \"enable_utilization_telemetry\": " + newVal + L"\n}\n";
-            changed = true;
-        }
+    static const BridgeFunctions& UnboundFunctions()
+    {
+        static const BridgeFunctions unbound;
+        return unbound;
+    }
 
-        if (changed)
-        {
-            std::wofstream out(settingsPath);
-            if (!out) return false;
-            out << json;
-        }
-        return true;
-}
-#else
-    bool ApplyTrackingSetting(bool disable)
+    const BridgeFunctions& Bridge() const
     {
-        const std::string settingsPath = SettingsPath();
-        const std::string newVal = disable ? "false" : "true";
+        const BridgeFunctions* functions = _functions.load(std::memory_order_acquire);
+        return functions ? *functions : UnboundFunctions();
+    }
 
-        std::ifstream in(settingsPath);
-        std::stringstream buf;
-        if (in) buf << in.rdbuf();
-        std::string json = buf.str();
-        in.close();
+    void PublishFunctions()
+    {
+        _functions.store(&_bridge, std::memory_order_release);
+    }
 
-        const std::string key = "\"enable_utilization_telemetry\"";
-        bool changed = false;
+    // Worker pool for the *Async calls, created on first use.
+    std::mutex _tasksMutex;
+    std::unique_ptr<BridgeTaskPool> _tasks;
+    unsigned _asyncThreads = 1;
+    size_t _asyncQueueDepth = 8;
 
-        size_t k = json.find(key);
-        if (k != std::string::npos)                                            // key exists patch value
-        {
-            size_t colon = json.find(":", k + key.length());
-            size_t v0 = json.find_first_of("\"tf", colon + 1);
-            size_t v1 = json.find_first_of(",}\n\r", v0);
-            if (v0 != std::string::npos && v1 != std::string::npos &&
-                json.substr(v0, v1 - v0).find(newVal) == std::string::npos)
-            {
-                json.replace(v0, v1 - v0, newVal);
-                changed = true;
-            }
-        }
-        else                                                                   // key missing insert
+    BridgeTaskPool& Tasks()
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        if (!_tasks)
         {
-            size_t brace = json.find_last_of('}');
-            std::string ins = "\n    \"enable_utilization_telemetry\": " + newVal + ",\n";
-            if (brace != std::string::npos) json.insert(brace, ins);
-            else json = "{\n    \"enable_utilization_telemetry\": " + newVal + "\n}\n";
-            changed = true;
+            _tasks = std::make_unique<BridgeTaskPool>(_asyncThreads, _asyncQueueDepth);
         }
+        return *_tasks;
+    }
 
-        if (changed)
+    // Async work calls into the runtime, so it has to finish before the runtime is
+    // unloaded. Queued work is cancelled and running work is waited for.
+    void DrainTasks()
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        if (_tasks)
         {
-            std::ofstream out(settingsPath);
-            if (!out) return false;
-            out << json;
-        }
-        return true;
+            _tasks->CancelPending();
+            _tasks->WaitIdle();
+        }
+    }
+
+    // Serializes snapshot rebuilds so concurrent refreshes do not bump the
+    // generation twice for one change.
+    std::mutex _displayMutex;
+
+    // Disk cache of the display list; empty path means disabled. The last file
+    // contents written are kept so an unchanged snapshot is not rewritten.
+    // Guarded by _displayMutex.
+    std::filesystem::path _displayCachePath;
+    std::string _displayCacheWritten;
+
+    // Published with std::atomic_load/atomic_store so a reader always sees a
+    // complete snapshot. The generation keeps counting across re-initialization.
+    std::shared_ptr<const DisplaySnapshot> _displaySnapshot;
+    std::atomic<uint64_t> _displayGeneration{ 0 };
+
+    template<typename T>
+    void BindFunction(T& func, const char* functionName)
+    {
+        func = _library.LoadFunction<T>(functionName);
+    }
+
+    bool OpenRuntime()
+    {
+        return _library.Open(_libraryPath, _bindNow);
+    }
+
+    void CloseRuntime()
+    {
+        _functions.store(nullptr, std::memory_order_release);
+        std::atomic_store(&_displaySnapshot, std::shared_ptr<const DisplaySnapshot>());
+        _bridge = BridgeFunctions();
+        _library.Close();
+        _initialized = false;
+    }
+
+    bool BindFunctions()
+    {
+        _bridge = BridgeFunctions();
+
+        BindFunction(_bridge.initialize_bridge, "initialize_bridge");
+        BindFunction(_bridge.uninitialize_bridge, "uninitialize_bridge");
+        BindFunction(_bridge.get_bridge_version, "get_bridge_version");
+        BindFunction(_bridge.instance_window_gl, "instance_window_gl");
+        BindFunction(_bridge.instance_offscreen_window_gl, "instance_offscreen_window_gl");
+        BindFunction(_bridge.get_offscreen_window_texture_gl, "get_offscreen_window_texture_gl");
+        BindFunction(_bridge.quiltify_rgbd, "quiltify_rgbd");
+        BindFunction(_bridge.get_window_dimensions, "get_window_dimensions");
+        BindFunction(_bridge.get_max_texture_size, "get_max_texture_size");
+        BindFunction(_bridge.set_interop_quilt_texture_gl, "set_interop_quilt_texture_gl");
+        BindFunction(_bridge.draw_interop_quilt_texture_gl, "draw_interop_quilt_texture_gl");
+        BindFunction(_bridge.draw_interop_rgbd_texture_gl, "draw_interop_rgbd_texture_gl");
+        BindFunction(_bridge.show_window, "show_window");
+        BindFunction(_bridge.save_texture_to_file_gl, "save_texture_to_file_gl");
+        BindFunction(_bridge.save_image_to_file, "save_image_to_file");
+        BindFunction(_bridge.device_from_resource_dx, "device_from_resource_dx");
+        BindFunction(_bridge.release_device_dx, "release_device_dx");
+        BindFunction(_bridge.instance_window_dx, "instance_window_dx");
+        BindFunction(_bridge.register_texture_dx, "register_texture_dx");
+        BindFunction(_bridge.unregister_texture_dx, "unregister_texture_dx");
+        BindFunction(_bridge.save_texture_to_file_dx, "save_texture_to_file_dx");
+        BindFunction(_bridge.draw_interop_quilt_texture_dx, "draw_interop_quilt_texture_dx");
+        BindFunction(_bridge.draw_interop_rgbd_texture_dx, "draw_interop_rgbd_texture_dx");
+        BindFunction(_bridge.create_texture_dx, "create_texture_dx");
+        BindFunction(_bridge.release_texture_dx, "release_texture_dx");
+        BindFunction(_bridge.copy_texture_dx, "copy_texture_dx");
+        BindFunction(_bridge.get_offscreen_window_texture_dx, "get_offscreen_window_texture_dx");
+        BindFunction(_bridge.instance_offscreen_window_dx, "instance_offscreen_window_dx");
+        BindFunction(_bridge.instance_window_metal, "instance_window_metal");
+        BindFunction(_bridge.create_metal_texture_with_iosurface, "create_metal_texture_with_iosurface");
+        BindFunction(_bridge.copy_metal_texture, "copy_metal_texture");
+        BindFunction(_bridge.release_metal_texture, "release_metal_texture");
+        BindFunction(_bridge.save_metal_texture_to_file, "save_metal_texture_to_file");
+        BindFunction(_bridge.draw_interop_quilt_texture_metal, "draw_interop_quilt_texture_metal");
+        BindFunction(_bridge.instance_offscreen_window_metal, "instance_offscreen_window_metal");
+        BindFunction(_bridge.get_offscreen_window_texture_metal, "get_offscreen_window_texture_metal");
+        BindFunction(_bridge.get_calibration, "get_calibration");
+        BindFunction(_bridge.get_device_name, "get_device_name");
+        BindFunction(_bridge.get_device_serial, "get_device_serial");
+        BindFunction(_bridge.get_default_quilt_settings, "get_default_quilt_settings");
+        BindFunction(_bridge.get_displays, "get_displays");
+        BindFunction(_bridge.get_device_name_for_display, "get_device_name_for_display");
+        BindFunction(_bridge.get_device_serial_for_display, "get_device_serial_for_display");
+        BindFunction(_bridge.get_dimensions_for_display, "get_dimensions_for_display");
+        BindFunction(_bridge.get_device_type_for_display, "get_device_type_for_display");
+        BindFunction(_bridge.get_calibration_for_display, "get_calibration_for_display");
+        BindFunction(_bridge.get_invview_for_display, "get_invview_for_display");
+        BindFunction(_bridge.get_ri_for_display, "get_ri_for_display");
+        BindFunction(_bridge.get_bi_for_display, "get_bi_for_display");
+        BindFunction(_bridge.get_tilt_for_display, "get_tilt_for_display");
+        BindFunction(_bridge.get_displayaspect_for_display, "get_displayaspect_for_display");
+        BindFunction(_bridge.get_fringe_for_display, "get_fringe_for_display");
+        BindFunction(_bridge.get_subp_for_display, "get_subp_for_display");
+        BindFunction(_bridge.get_viewcone_for_display, "get_viewcone_for_display");
+        BindFunction(_bridge.get_display_for_window, "get_display_for_window");
+        BindFunction(_bridge.get_default_quilt_settings_for_display, "get_default_quilt_settings_for_display");
+        BindFunction(_bridge.get_device_type, "get_device_type");
+        BindFunction(_bridge.get_pitch_for_display, "get_pitch_for_display");
+        BindFunction(_bridge.get_center_for_display, "get_center_for_display");
+        BindFunction(_bridge.get_viewcone, "get_viewcone");
+        BindFunction(_bridge.get_invview, "get_invview");
+        BindFunction(_bridge.get_ri, "get_ri");
+        BindFunction(_bridge.get_bi, "get_bi");
+        BindFunction(_bridge.get_tilt, "get_tilt");
+        BindFunction(_bridge.get_displayaspect, "get_displayaspect");
+        BindFunction(_bridge.get_fringe, "get_fringe");
+        BindFunction(_bridge.get_subp, "get_subp");
+        BindFunction(_bridge.get_pitch, "get_pitch");
+        BindFunction(_bridge.get_center, "get_center");
+        BindFunction(_bridge.get_window_position, "get_window_position");
+        BindFunction(_bridge.get_window_position_for_display, "get_window_position_for_display");
+
+        return _bridge.initialize_bridge != nullptr;
+    }
+
+    // ---------------------------------------------------------------- telemetry --
+    // NOTE: These functions must be called before initializing bridge
+private:
+    bool ApplyTrackingSetting(bool disable)
+    {
+        return BridgeSettingsCache::Shared().SetTelemetryEnabled(SettingsPath(), !disable);
     }
-#endif
 
 public:
 #ifndef _WIN32
@@ -309,205 +542,17 @@ public:
 #ifdef _WIN32
     std::wstring BridgeInstallLocation(const std::wstring& requestedVersion)
     {
-        std::wstring settingsPath = SettingsPath();
-        std::wifstream settingsFile(settingsPath);
-        std::wstring ret = L"";
-        if (settingsFile)
-        {
-            // Read file content into a wstring
-            std::wstringstream buffer;
-            buffer << settingsFile.rdbuf();
-            std::wstring settingsContent = buffer.str();
-
-            // Locate "install_locations" and the subsequent array
-            size_t start = settingsContent.find(L"\"install_locations\":");
-            if (start != std::wstring::npos)
-            {
-                start = settingsContent.find(L"[", start);
-                if (start != std::wstring::npos)
-                {
-                    size_t end = settingsContent.find(L"]", start);
-                    if (end != std::wstring::npos)
-                    {
-                        std::wstring arrayContent = settingsContent.substr(start + 1, end - start - 1);
-                        std::vector<std::wstring> tokens;
-                        size_t objStart = 0, objEnd = 0;
-
-                        while ((objStart = arrayContent.find(L"{", objEnd)) != std::wstring::npos)
-                        {
-                            objEnd = arrayContent.find(L"}", objStart);
-                            if (objEnd == std::wstring::npos) break;
-
-                            std::wstring entry = arrayContent.substr(objStart, objEnd - objStart + 1);
-                            tokens.push_back(entry);
-
-                            objEnd++;
-                        }
-
-                        // Parse each token to build a map of versions to paths
-                        std::map<std::wstring, std::wstring> versionPaths;
-                        for (const std::wstring& token : tokens)
-                        {
-                            size_t versionKey = token.find(L"\"version\":");
-                            size_t pathKey = token.find(L"\"path\":");
-                            if (versionKey != std::wstring::npos && pathKey != std::wstring::npos)
-                            {
-                                size_t versionStart = token.find(L"\"", versionKey + 10) + 1;
-                                size_t versionEnd = token.find(L"\"", versionStart);
-                                std::wstring version = token.substr(versionStart, versionEnd - versionStart);
-
-                                size_t pathStart = token.find(L"\"", pathKey + 7) + 1;
-                                size_t pathEnd = token.find(L"\"", pathStart);
-                                std::wstring path = token.substr(pathStart, pathEnd - pathStart);
-
-                                versionPaths[version] = path;
-                            }
-                        }
-
-                        // Remove versions below the minimum allowed version
-                        for (auto it = versionPaths.begin(); it != versionPaths.end();)
-                        {
-                            if (it->first < MinBridgeVersion)
-                            {
-                                it = versionPaths.erase(it);
-                            }
-                            else
-                            {
-                                ++it;
-                            }
-                        }
-
-                        // First, check if the requested version exists
-                        if (versionPaths.find(requestedVersion) != versionPaths.end())
-                        {
-                            return versionPaths[requestedVersion];
-                        }
-
-                        // Find the highest version with the same major version number
-                        std::wstring majorVersionOfRequested = requestedVersion.substr(0, requestedVersion.find(L'.'));
-                        std::wstring highestVersion;
-                        for (const auto& vp : versionPaths)
-                        {
-                            if (vp.first.substr(0, vp.first.find(L'.')) == majorVersionOfRequested)
-                            {
-                                if (highestVersion.empty() || vp.first > highestVersion)
-                                {
-                                    highestVersion = vp.first;
-                                }
-                            }
-                        }
-
-                        if (!highestVersion.empty())
-                        {
-                            return versionPaths[highestVersion];
-                        }
-                    }
-                }
-            }
-        }
+        // Version strings are plain ASCII
+        std::string requested(requestedVersion.begin(), requestedVersion.end());
+        std::string minimum(std::begin(MinBridgeVersion), std::end(MinBridgeVersion) - 1);
 
-        return ret;  // Return an empty string if no matching version found
+        std::string location = BridgeSettingsCache::Shared().ResolveInstallLocation(SettingsPath(), requested, minimum);
+        return std::filesystem::u8path(location).wstring();
     }
 #else
     std::string BridgeInstallLocation(const std::string& requestedVersion)
     {
-        std::string settingsPath = SettingsPath();
-        std::ifstream settingsFile(settingsPath);
-        std::string ret = "";
-        if (settingsFile)
-        {
-            // Read file content into a string
-            std::stringstream buffer;
-            buffer << settingsFile.rdbuf();
-            std::string settingsContent = buffer.str();
-
-            // Locate "install_locations" and the subsequent array
-            size_t start = settingsContent.find("\"install_locations\":");
-            if (start != std::string::npos)
-            {
-                start = settingsContent.find("[", start);
-                if (start != std::string::npos)
-                {
-                    size_t end = settingsContent.find("]", start);
-                    if (end != std::string::npos)
-                    {
-                        std::string arrayContent = settingsContent.substr(start + 1, end - start - 1);
-                        std::vector<std::string> tokens;
-                        size_t objStart = 0, objEnd = 0;
-
-                        while ((objStart = arrayContent.find("{", objEnd)) != std::string::npos)
-                        {
-                            objEnd = arrayContent.find("}", objStart);
-                            if (objEnd == std::string::npos) break;
-
-                            std::string entry = arrayContent.substr(objStart, objEnd - objStart + 1);
-                            tokens.push_back(entry);
-
-                            objEnd++;
-                        }
-
-                        // Parse each token to build a map of versions to paths
-                        std::map<std::string, std::string> versionPaths;
-                        for (const std::string& token : tokens)
-                        {
-                            size_t versionKey = token.find("\"version\":");
-                            size_t pathKey = token.find("\"path\":");
-                            if (versionKey != std::string::npos && pathKey != std::string::npos)
-                            {
-                                size_t versionStart = token.find("\"", versionKey + 10) + 1;
-                                size_t versionEnd = token.find("\"", versionStart);
-                                std::string version = token.substr(versionStart, versionEnd - versionStart);
-
-                                size_t pathStart = token.find("\"", pathKey + 7) + 1;
-                                size_t pathEnd = token.find("\"", pathStart);
-                                std::string path = token.substr(pathStart, pathEnd - pathStart);
-
-                                versionPaths[version] = path;
-                            }
-                        }
-
-                        // Remove versions below the minimum allowed version
-                        for (auto it = versionPaths.begin(); it != versionPaths.end();)
-                        {
-                            if (it->first < MinBridgeVersion)
-                            {
-                                it = versionPaths.erase(it);
-                            }
-                            else
-                            {
-                                ++it;
-                            }
-                        }
-
-                        // First, check if the requested version exists
-                        if (versionPaths.find(requestedVersion) != versionPaths.end())
-                        {
-                            return versionPaths[requestedVersion];
-                        }
-
-                        // Find the highest version with the same major version number
-                        std::string majorVersionOfRequested = requestedVersion.substr(0, requestedVersion.find('.'));
-                        std::string highestVersion;
-                        for (const auto& vp : versionPaths)
-                        {
-                            if (vp.first.substr(0, vp.first.find('.')) == majorVersionOfRequested)
-                            {
-                                if (highestVersion.empty() || vp.first > highestVersion)
-                                {
-                                    highestVersion = vp.first;
-                                }
-                            }
-                        }
-
-                        if (!highestVersion.empty())
-                        {
-                            return versionPaths[highestVersion];
-                        }
-                    }
-                }
-            }
-        }
-        return ret;  // Return an empty string if no matching version found
+        return BridgeSettingsCache::Shared().ResolveInstallLocation(SettingsPath(), requestedVersion, MinBridgeVersion);
     }
 #endif
 
@@ -529,10 +574,10 @@ bool Initialize(const std::wstring& app_name, const std::wstring& desired_bridge
     return initialized;
 }
 #else
-bool Initialize(const std::string& app_name, const std::string& desired_bridge_version = ::BridgeVersion)
+bool Initialize(const std::string& app_name, const std::string& desired_bridge_version = ::BridgeVersion, bool disableTracking = false)
 {
     std::string installPath = BridgeInstallLocation(desired_bridge_version);
-    bool initialized = InitializeWithPath(app_name, installPath);
+    bool initialized = InitializeWithPath(app_name, installPath, disableTracking);
 
     if (!initialized)
     {
@@ -558,66 +603,147 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
             return false;
         }
 
+        std::lock_guard<std::recursive_mutex> lock(_lifecycleMutex);
+
+        if (_initialized)
+        {
+            Uninitialize();
+        }
+
         ApplyTrackingSetting(disableTracking);
 
 #ifdef __APPLE__
         _libraryPath = (std::filesystem::path(manual_install_location) / "libbridge_inproc.dylib").string();
+#elif _WIN32
+        SetDllDirectoryW(manual_install_location.c_str());
+        _libraryPath = (std::filesystem::path(manual_install_location) / "bridge_inproc.dll").wstring();
+#else
+        _libraryPath = (std::filesystem::path(manual_install_location) / "libbridge_inproc.so").string();
+#endif
         try
         {
-            auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(const char*)>(_libraryPath, "initialize_bridge");
-
-            if (!func)
+            if (!OpenRuntime() || !BindFunctions())
             {
+                CloseRuntime();
                 return false;
             }
 
-            return func(app_name.c_str());
-        }
-        catch (const std::exception& ex)
-        {
-            std::cerr << "Error: " << ex.what() << std::endl;
-            return false;
-        }
-#elif _WIN32
-        SetDllDirectoryW(manual_install_location.c_str());
-        _libraryPath = (std::filesystem::path(manual_install_location) / "bridge_inproc.dll").wstring();
-        try
-        {
-            auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(const wchar_t*)>(_libraryPath, "initialize_bridge");
+            BRIDGE_PROFILE_CALL(initialize_bridge);
+            auto func = _bridge.initialize_bridge;
 
-            if (!func)
+            if (!func || !func(app_name.c_str()))
             {
+                CloseRuntime();
                 return false;
             }
 
-            return func(app_name.c_str());
+            PublishFunctions();
+            _initialized = true;
+            return true;
         }
         catch (const std::exception& ex)
         {
             std::cerr << "Error: " << ex.what() << std::endl;
+            CloseRuntime();
             return false;
         }
+    }
+
+    // Shuts the runtime down and releases the library handle. Windows and textures
+    // created through this controller are invalid afterwards.
+    bool Uninitialize()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_lifecycleMutex);
+
+        DrainTasks();
+
+        BRIDGE_PROFILE_CALL(uninitialize_bridge);
+        auto func = _bridge.uninitialize_bridge;
+        bool result = func ? func() : false;
+
+        CloseRuntime();
+        return result;
+    }
+
+    // Opens the runtime with RTLD_NOW on the next Initialize, so the first frame does
+    // not pay lazy symbol binding inside the runtime. Call before Initialize.
+    void SetBindNow(bool bindNow)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_lifecycleMutex);
+        _bindNow = bindNow;
+    }
+
+    bool IsInitialized() const
+    {
+        return _initialized;
+    }
+
+    // Per entry point call counts and latency percentiles as JSON, for every thread
+    // that called through a Controller. Only collected when built with
+    // BRIDGE_INSTRUMENTATION; otherwise this returns {"enabled":false}.
+    std::string GetInstrumentationJson() const
+    {
+#ifdef BRIDGE_INSTRUMENTATION
+        return BridgeProfiler::Shared().Dump();
 #else
-        // todo: linux
+        return "{\"enabled\":false}";
 #endif
-        return false;
     }
 
-    bool Uninitialize()
+    void ResetInstrumentation()
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)()>(_libraryPath, "uninitialize_bridge");
+#ifdef BRIDGE_INSTRUMENTATION
+        BridgeProfiler::Shared().Reset();
+#endif
+    }
 
-        if (!func)
+    // Worker threads and queue depth for the *Async calls. Takes effect the next time
+    // the pool is created, i.e. call it before the first async call. Once the queue
+    // is full further async calls are rejected rather than queued.
+    void SetAsyncLimits(unsigned threads, size_t queueDepth)
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _asyncThreads = threads;
+        _asyncQueueDepth = queueDepth;
+    }
+
+    // Switches to another installed Bridge version without restarting the process.
+    // The current runtime is uninitialized and unloaded first, so every window must
+    // be recreated afterwards.
+#ifdef _WIN32
+    bool SwitchBridgeVersion(const std::wstring& app_name, const std::wstring& bridge_version, bool disableTracking = false)
+#else
+    bool SwitchBridgeVersion(const std::string& app_name, const std::string& bridge_version, bool disableTracking = false)
+#endif
+    {
+        std::lock_guard<std::recursive_mutex> lock(_lifecycleMutex);
+
+        if (_initialized)
         {
-            return false;
+            Uninitialize();
         }
 
-        return func();
+        return Initialize(app_name, bridge_version, disableTracking);
+    }
+
+    ~Controller()
+    {
+        // stop the workers while every member they might touch is still alive
+        {
+            std::lock_guard<std::mutex> lock(_tasksMutex);
+            _tasks.reset();
+        }
+
+        if (_initialized)
+        {
+            Uninitialize();
+        }
     }
 
     bool GetBridgeVersion(unsigned long* major, unsigned long* minor, unsigned long* build, int* number_of_postfix_wchars, wchar_t* postfix)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long*, unsigned long*, unsigned long*, int*, wchar_t*)>(_libraryPath, "get_bridge_version");
+        BRIDGE_PROFILE_CALL(get_bridge_version);
+        auto func = Bridge().get_bridge_version;
 
         if (!func)
         {
@@ -629,7 +755,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool InstanceWindowGL(WINDOW_HANDLE* wnd, unsigned long display_index = static_cast<unsigned long>(FIRST_LOOKING_GLASS_DEVICE))
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE*, unsigned long)>(_libraryPath, "instance_window_gl");
+        BRIDGE_PROFILE_CALL(instance_window_gl);
+        auto func = Bridge().instance_window_gl;
 
         if (!func)
         {
@@ -641,7 +768,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool InstanceOffscreenWindowGL(WINDOW_HANDLE* wnd, unsigned long display_index = static_cast<unsigned long>(FIRST_LOOKING_GLASS_DEVICE))
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE*, unsigned long)>(_libraryPath, "instance_offscreen_window_gl");
+        BRIDGE_PROFILE_CALL(instance_offscreen_window_gl);
+        auto func = Bridge().instance_offscreen_window_gl;
 
         if (!func)
         {
@@ -653,8 +781,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetOffscreenWindowTextureGL(WINDOW_HANDLE wnd, unsigned long long* texture, PixelFormats* format, unsigned long* width, unsigned long* height)
     {
-        using FuncType = bool(*)(WINDOW_HANDLE, unsigned long long*, PixelFormats*, unsigned long*, unsigned long*);
-        auto func = _DynamicLibraryLoader.LoadFunction<FuncType>(_libraryPath, "get_offscreen_window_texture_gl");
+        BRIDGE_PROFILE_CALL(get_offscreen_window_texture_gl);
+        auto func = Bridge().get_offscreen_window_texture_gl;
 
         if (!func)
         {
@@ -666,7 +794,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool QuiltifyRGBD(WINDOW_HANDLE wnd, unsigned long columns, unsigned long rows, unsigned long views, float aspect, float zoom, float cam_dist, float fov, float crop_pos_x, float crop_pos_y, unsigned long depth_inversion, unsigned long chroma_depth, unsigned long depth_loc, float depthiness, float depth_cutoff, float focus, const wchar_t* input_path, const wchar_t* output_path)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long, unsigned long, unsigned long, float, float, float, float, float, float, unsigned long, unsigned long, unsigned long, float, float, float, const wchar_t*, const wchar_t*)>(_libraryPath, "quiltify_rgbd");
+        BRIDGE_PROFILE_CALL(quiltify_rgbd);
+        auto func = Bridge().quiltify_rgbd;
 
         if (!func)
         {
@@ -678,7 +807,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetWindowDimensions(WINDOW_HANDLE wnd, unsigned long* width, unsigned long* height)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long*, unsigned long*)>(_libraryPath, "get_window_dimensions");
+        BRIDGE_PROFILE_CALL(get_window_dimensions);
+        auto func = Bridge().get_window_dimensions;
 
         if (!func)
         {
@@ -690,7 +820,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetMaxTextureSize(WINDOW_HANDLE wnd, unsigned long* size)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long*)>(_libraryPath, "get_max_texture_size");
+        BRIDGE_PROFILE_CALL(get_max_texture_size);
+        auto func = Bridge().get_max_texture_size;
 
         if (!func)
         {
@@ -702,7 +833,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool SetInteropQuiltTextureGL(WINDOW_HANDLE wnd, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height, unsigned long vx, unsigned long vy, float aspect, float zoom)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long long, PixelFormats, unsigned long, unsigned long, unsigned long, unsigned long, float, float)>(_libraryPath, "set_interop_quilt_texture_gl");
+        BRIDGE_PROFILE_CALL(set_interop_quilt_texture_gl);
+        auto func = Bridge().set_interop_quilt_texture_gl;
 
         if (!func)
         {
@@ -714,7 +846,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool DrawInteropQuiltTextureGL(WINDOW_HANDLE wnd, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height, unsigned long vx, unsigned long vy, float aspect, float zoom)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long long, PixelFormats, unsigned long, unsigned long, unsigned long, unsigned long, float, float)>(_libraryPath, "draw_interop_quilt_texture_gl");
+        BRIDGE_PROFILE_CALL(draw_interop_quilt_texture_gl);
+        auto func = Bridge().draw_interop_quilt_texture_gl;
 
         if (!func)
         {
@@ -726,7 +859,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool DrawInteropRGBDTextureGL(WINDOW_HANDLE wnd, unsigned long texture, PixelFormats format, unsigned int width, unsigned int height, unsigned int quiltWidth, unsigned int quiltHeight, unsigned int vx, unsigned int vy, float focus, float offset, float aspect, float zoom, int depth_loc)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long, PixelFormats, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, float, float, float, float, int)>(_libraryPath, "draw_interop_rgbd_texture_gl");
+        BRIDGE_PROFILE_CALL(draw_interop_rgbd_texture_gl);
+        auto func = Bridge().draw_interop_rgbd_texture_gl;
 
         if (!func)
         {
@@ -738,7 +872,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool ShowWindow(WINDOW_HANDLE wnd, bool flag)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, bool)>(_libraryPath, "show_window");
+        BRIDGE_PROFILE_CALL(show_window);
+        auto func = Bridge().show_window;
 
         if (!func)
         {
@@ -752,7 +887,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifdef WIN32
     bool SaveTextureToFileGL(WINDOW_HANDLE wnd, wchar_t* filename, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, wchar_t*, unsigned long long, PixelFormats, unsigned long, unsigned long)>(_libraryPath, "save_texture_to_file_gl");
+        BRIDGE_PROFILE_CALL(save_texture_to_file_gl);
+        auto func = Bridge().save_texture_to_file_gl;
 
         if (!func)
         {
@@ -764,7 +900,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool SaveImageToFile(WINDOW_HANDLE wnd, wchar_t* filename, void* image, PixelFormats format, unsigned long width, unsigned long height)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, wchar_t*, void*, PixelFormats, unsigned long, unsigned long)>(_libraryPath, "save_image_to_file");
+        BRIDGE_PROFILE_CALL(save_image_to_file);
+        auto func = Bridge().save_image_to_file;
 
         if (!func)
         {
@@ -776,7 +913,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #else
     bool SaveTextureToFileGL(WINDOW_HANDLE wnd, char* filename, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, char*, unsigned long long, PixelFormats, unsigned long, unsigned long)>(_libraryPath, "save_texture_to_file_gl");
+        BRIDGE_PROFILE_CALL(save_texture_to_file_gl);
+        auto func = Bridge().save_texture_to_file_gl;
 
         if (!func)
         {
@@ -788,7 +926,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool SaveImageToFile(WINDOW_HANDLE wnd, char* filename, void* image, PixelFormats format, unsigned long width, unsigned long height)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, char*, void*, PixelFormats, unsigned long, unsigned long)>(_libraryPath, "save_image_to_file");
+        BRIDGE_PROFILE_CALL(save_image_to_file);
+        auto func = Bridge().save_image_to_file;
 
         if (!func)
         {
@@ -799,13 +938,57 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
     }
 #endif
 
+    // ------------------------------------------------------------------- async --
+    // These run the blocking call on the Controller's worker pool, so the render
+    // thread only pays for copying the arguments. The future throws
+    // BridgeTaskCancelled if the call was rejected because the queue was full, or
+    // was cancelled through the token before it started.
+    //
+    // There is no async SaveTextureToFileGL: it reads an OpenGL texture, which
+    // needs the caller's GL context current. Read the pixels back on the render
+    // thread, through pixel pack buffers to keep glReadPixels from stalling, and
+    // pass them to SaveImageToFileAsync instead.
+
+    std::future<bool> QuiltifyRGBDAsync(WINDOW_HANDLE wnd, unsigned long columns, unsigned long rows, unsigned long views, float aspect, float zoom, float cam_dist, float fov, float crop_pos_x, float crop_pos_y, unsigned long depth_inversion, unsigned long chroma_depth, unsigned long depth_loc, float depthiness, float depth_cutoff, float focus, std::wstring input_path, std::wstring output_path, BridgeCancelToken token = BridgeCancelToken())
+    {
+        return Tasks().Submit([=]()
+        {
+            return QuiltifyRGBD(wnd, columns, rows, views, aspect, zoom, cam_dist, fov, crop_pos_x, crop_pos_y, depth_inversion, chroma_depth, depth_loc, depthiness, depth_cutoff, focus, input_path.c_str(), output_path.c_str());
+        }, token);
+    }
+
+    // image is moved into the task, so the caller's buffer can be reused immediately.
+#ifdef _WIN32
+    std::future<bool> SaveImageToFileAsync(WINDOW_HANDLE wnd, std::wstring filename, std::vector<unsigned char> image, PixelFormats format, unsigned long width, unsigned long height, BridgeCancelToken token = BridgeCancelToken())
+#else
+    std::future<bool> SaveImageToFileAsync(WINDOW_HANDLE wnd, std::string filename, std::vector<unsigned char> image, PixelFormats format, unsigned long width, unsigned long height, BridgeCancelToken token = BridgeCancelToken())
+#endif
+    {
+        auto pixels = std::make_shared<std::vector<unsigned char>>(std::move(image));
+
+        return Tasks().Submit([=]()
+        {
+            auto name = filename;
+            return SaveImageToFile(wnd, &name[0], pixels->data(), format, width, height);
+        }, token);
+    }
+
+    std::future<std::vector<DisplayInfo>> GetDisplayInfoListAsync(BridgeCancelToken token = BridgeCancelToken())
+    {
+        return Tasks().Submit([this]()
+        {
+            return GetDisplayInfoList();
+        }, token);
+    }
+
     bool DeviceFromResourceDX(IUnknown* dx_resource, IUnknown** dx_device)
     {
 #ifndef _WIN32
         return false;
 #endif
 
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(IUnknown*, IUnknown**)>(_libraryPath, "device_from_resource_dx");
+        BRIDGE_PROFILE_CALL(device_from_resource_dx);
+        auto func = Bridge().device_from_resource_dx;
 
         if (!func)
         {
@@ -821,7 +1004,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
         return false;
 #endif
 
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(IUnknown*)>(_libraryPath, "release_device_dx");
+        BRIDGE_PROFILE_CALL(release_device_dx);
+        auto func = Bridge().release_device_dx;
 
         if (!func)
         {
@@ -837,7 +1021,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
         return false;
 #endif
 
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(IUnknown*, WINDOW_HANDLE*, unsigned long)>(_libraryPath, "instance_window_dx");
+        BRIDGE_PROFILE_CALL(instance_window_dx);
+        auto func = Bridge().instance_window_dx;
 
         if (!func)
         {
@@ -852,7 +1037,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown*)>(_libraryPath, "register_texture_dx");
+        BRIDGE_PROFILE_CALL(register_texture_dx);
+        auto func = Bridge().register_texture_dx;
 
         if (!func)
         {
@@ -867,7 +1053,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown*)>(_libraryPath, "unregister_texture_dx");
+        BRIDGE_PROFILE_CALL(unregister_texture_dx);
+        auto func = Bridge().unregister_texture_dx;
 
         if (!func)
         {
@@ -882,7 +1069,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, wchar_t*, IUnknown*)>(_libraryPath, "save_texture_to_file_dx");
+        BRIDGE_PROFILE_CALL(save_texture_to_file_dx);
+        auto func = Bridge().save_texture_to_file_dx;
 
         if (!func)
         {
@@ -897,7 +1085,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown*, unsigned long, unsigned long, float, float)>(_libraryPath, "draw_interop_quilt_texture_dx");
+        BRIDGE_PROFILE_CALL(draw_interop_quilt_texture_dx);
+        auto func = Bridge().draw_interop_quilt_texture_dx;
 
         if (!func)
         {
@@ -912,7 +1101,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown*, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, float, float, float, float, int)>(_libraryPath, "draw_interop_rgbd_texture_dx");
+        BRIDGE_PROFILE_CALL(draw_interop_rgbd_texture_dx);
+        auto func = Bridge().draw_interop_rgbd_texture_dx;
 
         if (!func)
         {
@@ -927,7 +1117,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long, unsigned long, IUnknown**)>(_libraryPath, "create_texture_dx");
+        BRIDGE_PROFILE_CALL(create_texture_dx);
+        auto func = Bridge().create_texture_dx;
 
         if (!func)
         {
@@ -942,7 +1133,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown*)>(_libraryPath, "release_texture_dx");
+        BRIDGE_PROFILE_CALL(release_texture_dx);
+        auto func = Bridge().release_texture_dx;
 
         if (!func)
         {
@@ -957,7 +1149,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown*, IUnknown*)>(_libraryPath, "copy_texture_dx");
+        BRIDGE_PROFILE_CALL(copy_texture_dx);
+        auto func = Bridge().copy_texture_dx;
 
         if (!func)
         {
@@ -972,7 +1165,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef _WIN32
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, IUnknown**)>(_libraryPath, "get_offscreen_window_texture_dx");
+        BRIDGE_PROFILE_CALL(get_offscreen_window_texture_dx);
+        auto func = Bridge().get_offscreen_window_texture_dx;
 
         if (!func)
         {
@@ -988,7 +1182,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
         return false;
 #endif
         // Load the function from the dynamic library
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(IUnknown*, WINDOW_HANDLE*, unsigned long)>(_libraryPath, "instance_offscreen_window_dx");
+        BRIDGE_PROFILE_CALL(instance_offscreen_window_dx);
+        auto func = Bridge().instance_offscreen_window_dx;
 
         // Check if the function was loaded successfully
         if (!func)
@@ -1005,7 +1200,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(void*, WINDOW_HANDLE*, unsigned long)>(_libraryPath, "instance_window_metal");
+        BRIDGE_PROFILE_CALL(instance_window_metal);
+        auto func = Bridge().instance_window_metal;
 
         if (!func)
         {
@@ -1020,7 +1216,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, void*, void**)>(_libraryPath, "create_metal_texture_with_iosurface");
+        BRIDGE_PROFILE_CALL(create_metal_texture_with_iosurface);
+        auto func = Bridge().create_metal_texture_with_iosurface;
 
         if (!func)
         {
@@ -1035,7 +1232,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, void*, void*)>(_libraryPath, "copy_metal_texture");
+        BRIDGE_PROFILE_CALL(copy_metal_texture);
+        auto func = Bridge().copy_metal_texture;
 
         if (!func)
         {
@@ -1050,7 +1248,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, void*)>(_libraryPath, "release_metal_texture");
+        BRIDGE_PROFILE_CALL(release_metal_texture);
+        auto func = Bridge().release_metal_texture;
 
         if (!func)
         {
@@ -1065,7 +1264,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, char*, void*, PixelFormats, unsigned long, unsigned long)>(_libraryPath, "save_metal_texture_to_file");
+        BRIDGE_PROFILE_CALL(save_metal_texture_to_file);
+        auto func = Bridge().save_metal_texture_to_file;
 
         if (!func)
         {
@@ -1080,7 +1280,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, void*, unsigned long, unsigned long, float, float)>(_libraryPath, "draw_interop_quilt_texture_metal");
+        BRIDGE_PROFILE_CALL(draw_interop_quilt_texture_metal);
+        auto func = Bridge().draw_interop_quilt_texture_metal;
 
         if (!func)
         {
@@ -1095,7 +1296,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(void*, WINDOW_HANDLE*, unsigned long)>(_libraryPath, "instance_offscreen_window_metal");
+        BRIDGE_PROFILE_CALL(instance_offscreen_window_metal);
+        auto func = Bridge().instance_offscreen_window_metal;
 
         if (!func)
         {
@@ -1110,7 +1312,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 #ifndef __APPLE__
         return false;
 #endif
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, void**)>(_libraryPath, "get_offscreen_window_texture_metal");
+        BRIDGE_PROFILE_CALL(get_offscreen_window_texture_metal);
+        auto func = Bridge().get_offscreen_window_texture_metal;
 
         if (!func)
         {
@@ -1135,7 +1338,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
         int* number_of_cells,
         CalibrationSubpixelCell* cells)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*, float*, float*, int*, int*, float*, float*, int*, float*, float*, int*, int*, CalibrationSubpixelCell*)>(_libraryPath, "get_calibration");
+        BRIDGE_PROFILE_CALL(get_calibration);
+        auto func = Bridge().get_calibration;
 
         if (!func)
         {
@@ -1147,7 +1351,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDeviceName(WINDOW_HANDLE wnd, int* number_of_device_name_wchars, wchar_t* device_name)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, int*, wchar_t*)>(_libraryPath, "get_device_name");
+        BRIDGE_PROFILE_CALL(get_device_name);
+        auto func = Bridge().get_device_name;
 
         if (!func)
         {
@@ -1159,7 +1364,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDeviceSerial(WINDOW_HANDLE wnd, int* number_of_serial_wchars, wchar_t* serial)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, int*, wchar_t*)>(_libraryPath, "get_device_serial");
+        BRIDGE_PROFILE_CALL(get_device_serial);
+        auto func = Bridge().get_device_serial;
 
         if (!func)
         {
@@ -1171,7 +1377,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDefaultQuiltSettings(WINDOW_HANDLE wnd, float* aspect, int* quilt_width, int* quilt_height, int* quilt_columns, int* quilt_rows)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*, int*, int*, int*, int*)>(_libraryPath, "get_default_quilt_settings");
+        BRIDGE_PROFILE_CALL(get_default_quilt_settings);
+        auto func = Bridge().get_default_quilt_settings;
 
         if (!func)
         {
@@ -1183,7 +1390,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDisplays(int* number_of_indices, unsigned long* indices)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(int*, unsigned long*)>(_libraryPath, "get_displays");
+        BRIDGE_PROFILE_CALL(get_displays);
+        auto func = Bridge().get_displays;
 
         if (!func)
         {
@@ -1195,7 +1403,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDeviceNameForDisplay(unsigned long display_index, int* number_of_device_name_wchars, wchar_t* device_name)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, int*, wchar_t*)>(_libraryPath, "get_device_name_for_display");
+        BRIDGE_PROFILE_CALL(get_device_name_for_display);
+        auto func = Bridge().get_device_name_for_display;
 
         if (!func)
         {
@@ -1207,7 +1416,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDeviceSerialForDisplay(unsigned long display_index, int* number_of_serial_wchars, wchar_t* serial)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, int*, wchar_t*)>(_libraryPath, "get_device_serial_for_display");
+        BRIDGE_PROFILE_CALL(get_device_serial_for_display);
+        auto func = Bridge().get_device_serial_for_display;
 
         if (!func)
         {
@@ -1219,7 +1429,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDimensionsForDisplay(unsigned long display_index, unsigned long* width, unsigned long* height)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, unsigned long*, unsigned long*)>(_libraryPath, "get_dimensions_for_display");
+        BRIDGE_PROFILE_CALL(get_dimensions_for_display);
+        auto func = Bridge().get_dimensions_for_display;
 
         if (!func)
         {
@@ -1231,7 +1442,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDeviceTypeForDisplay(unsigned long display_index, int* hw_enum)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, int*)>(_libraryPath, "get_device_type_for_display");
+        BRIDGE_PROFILE_CALL(get_device_type_for_display);
+        auto func = Bridge().get_device_type_for_display;
 
         if (!func)
         {
@@ -1256,7 +1468,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
         int* number_of_cells,
         CalibrationSubpixelCell* cells)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*, float*, float*, int*, int*, float*, float*, int*, float*, float*, int*, int*, CalibrationSubpixelCell*)>(_libraryPath, "get_calibration_for_display");
+        BRIDGE_PROFILE_CALL(get_calibration_for_display);
+        auto func = Bridge().get_calibration_for_display;
 
         if (!func)
         {
@@ -1269,7 +1482,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetInvViewForDisplay(unsigned long display_index, int* invview)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, int*)>(_libraryPath, "get_invview_for_display");
+        BRIDGE_PROFILE_CALL(get_invview_for_display);
+        auto func = Bridge().get_invview_for_display;
 
         if (!func)
         {
@@ -1281,7 +1495,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetRiForDisplay(unsigned long display_index, int* ri)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, int*)>(_libraryPath, "get_ri_for_display");
+        BRIDGE_PROFILE_CALL(get_ri_for_display);
+        auto func = Bridge().get_ri_for_display;
 
         if (!func)
         {
@@ -1293,7 +1508,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetBiForDisplay(unsigned long display_index, int* bi)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, int*)>(_libraryPath, "get_bi_for_display");
+        BRIDGE_PROFILE_CALL(get_bi_for_display);
+        auto func = Bridge().get_bi_for_display;
 
         if (!func)
         {
@@ -1305,7 +1521,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetTiltForDisplay(unsigned long display_index, float* tilt)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_tilt_for_display");
+        BRIDGE_PROFILE_CALL(get_tilt_for_display);
+        auto func = Bridge().get_tilt_for_display;
 
         if (!func)
         {
@@ -1317,7 +1534,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDisplayAspectForDisplay(unsigned long display_index, float* displayaspect)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_displayaspect_for_display");
+        BRIDGE_PROFILE_CALL(get_displayaspect_for_display);
+        auto func = Bridge().get_displayaspect_for_display;
 
         if (!func)
         {
@@ -1329,7 +1547,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetFringeForDisplay(unsigned long display_index, float* fringe)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_fringe_for_display");
+        BRIDGE_PROFILE_CALL(get_fringe_for_display);
+        auto func = Bridge().get_fringe_for_display;
 
         if (!func)
         {
@@ -1341,7 +1560,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetSubpForDisplay(unsigned long display_index, float* subp)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_subp_for_display");
+        BRIDGE_PROFILE_CALL(get_subp_for_display);
+        auto func = Bridge().get_subp_for_display;
 
         if (!func)
         {
@@ -1353,7 +1573,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetViewConeForDisplay(unsigned long display_index, float* viewcone)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_viewcone_for_display");
+        BRIDGE_PROFILE_CALL(get_viewcone_for_display);
+        auto func = Bridge().get_viewcone_for_display;
 
         if (!func)
         {
@@ -1365,7 +1586,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDisplayForWindow(WINDOW_HANDLE wnd, unsigned long* display_index)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, unsigned long*)>(_libraryPath, "get_display_for_window");
+        BRIDGE_PROFILE_CALL(get_display_for_window);
+        auto func = Bridge().get_display_for_window;
 
         if (!func)
         {
@@ -1377,7 +1599,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDefaultQuiltSettingsForDisplay(unsigned long display_index, float* aspect, int* quilt_width, int* quilt_height, int* quilt_columns, int* quilt_rows)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*, int*, int*, int*, int*)>(_libraryPath, "get_default_quilt_settings_for_display");
+        BRIDGE_PROFILE_CALL(get_default_quilt_settings_for_display);
+        auto func = Bridge().get_default_quilt_settings_for_display;
 
         if (!func)
         {
@@ -1389,7 +1612,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDeviceType(WINDOW_HANDLE wnd, int* hw_enum)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, int*)>(_libraryPath, "get_device_type");
+        BRIDGE_PROFILE_CALL(get_device_type);
+        auto func = Bridge().get_device_type;
 
         if (!func)
         {
@@ -1401,7 +1625,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetPitchForDisplay(unsigned long display_index, float* pitch)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_pitch_for_display");
+        BRIDGE_PROFILE_CALL(get_pitch_for_display);
+        auto func = Bridge().get_pitch_for_display;
 
         if (!func)
         {
@@ -1413,7 +1638,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetCenterForDisplay(unsigned long display_index, float* center)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, float*)>(_libraryPath, "get_center_for_display");
+        BRIDGE_PROFILE_CALL(get_center_for_display);
+        auto func = Bridge().get_center_for_display;
 
         if (!func)
         {
@@ -1425,7 +1651,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetViewCone(WINDOW_HANDLE wnd, float* viewcone)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_viewcone");
+        BRIDGE_PROFILE_CALL(get_viewcone);
+        auto func = Bridge().get_viewcone;
 
         if (!func)
         {
@@ -1437,7 +1664,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetInvView(WINDOW_HANDLE wnd, int* invview)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, int*)>(_libraryPath, "get_invview");
+        BRIDGE_PROFILE_CALL(get_invview);
+        auto func = Bridge().get_invview;
 
         if (!func)
         {
@@ -1449,7 +1677,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetRi(WINDOW_HANDLE wnd, int* ri)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, int*)>(_libraryPath, "get_ri");
+        BRIDGE_PROFILE_CALL(get_ri);
+        auto func = Bridge().get_ri;
 
         if (!func)
         {
@@ -1461,7 +1690,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetBi(WINDOW_HANDLE wnd, int* bi)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, int*)>(_libraryPath, "get_bi");
+        BRIDGE_PROFILE_CALL(get_bi);
+        auto func = Bridge().get_bi;
 
         if (!func)
         {
@@ -1473,7 +1703,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetTilt(WINDOW_HANDLE wnd, float* tilt)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_tilt");
+        BRIDGE_PROFILE_CALL(get_tilt);
+        auto func = Bridge().get_tilt;
 
         if (!func)
         {
@@ -1485,7 +1716,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetDisplayAspect(WINDOW_HANDLE wnd, float* displayaspect)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_displayaspect");
+        BRIDGE_PROFILE_CALL(get_displayaspect);
+        auto func = Bridge().get_displayaspect;
 
         if (!func)
         {
@@ -1497,7 +1729,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetFringe(WINDOW_HANDLE wnd, float* fringe)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_fringe");
+        BRIDGE_PROFILE_CALL(get_fringe);
+        auto func = Bridge().get_fringe;
 
         if (!func)
         {
@@ -1509,7 +1742,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetSubp(WINDOW_HANDLE wnd, float* subp)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_subp");
+        BRIDGE_PROFILE_CALL(get_subp);
+        auto func = Bridge().get_subp;
 
         if (!func)
         {
@@ -1521,7 +1755,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetPitch(WINDOW_HANDLE wnd, float* pitch)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_pitch");
+        BRIDGE_PROFILE_CALL(get_pitch);
+        auto func = Bridge().get_pitch;
 
         if (!func)
         {
@@ -1533,7 +1768,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetCenter(WINDOW_HANDLE wnd, float* center)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, float*)>(_libraryPath, "get_center");
+        BRIDGE_PROFILE_CALL(get_center);
+        auto func = Bridge().get_center;
 
         if (!func)
         {
@@ -1545,7 +1781,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetWindowPosition(WINDOW_HANDLE wnd, long* x, long* y)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(WINDOW_HANDLE, long*, long*)>(_libraryPath, "get_window_position");
+        BRIDGE_PROFILE_CALL(get_window_position);
+        auto func = Bridge().get_window_position;
 
         if (!func)
         {
@@ -1557,7 +1794,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
     bool GetWindowPositionForDisplay(unsigned long display_index, long* x, long* y)
     {
-        auto func = _DynamicLibraryLoader.LoadFunction<bool(*)(unsigned long, long*, long*)>(_libraryPath, "get_window_position_for_display");
+        BRIDGE_PROFILE_CALL(get_window_position_for_display);
+        auto func = Bridge().get_window_position_for_display;
 
         if (!func)
         {
@@ -1587,12 +1825,7 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
     void PopulateSingleDisplayInfo(unsigned long display_id, DisplayInfo& info) {
         info.display_id = display_id;
 
-        int serial_count = 0;
-        GetDeviceSerialForDisplay(display_id, &serial_count, nullptr);
-        if (serial_count > 0) {
-            info.serial.resize(serial_count);
-            GetDeviceSerialForDisplay(display_id, &serial_count, info.serial.data());
-        }
+        info.serial = QueryDisplaySerial(display_id);
 
         int name_count = 0;
         GetDeviceNameForDisplay(display_id, &name_count, nullptr);
@@ -1603,6 +1836,8 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
 
         GetDimensionsForDisplay(display_id, &info.dimensions.width, &info.dimensions.height);
         GetDeviceTypeForDisplay(display_id, &info.hw_enum);
+        // number_of_cells is output only, so the cells need a sizing call first. The
+        // snapshot cache keeps this off the per-frame path.
         int number_of_cells = 0;
         GetCalibrationForDisplay(display_id,
             &info.calibration.center,
@@ -1655,20 +1890,147 @@ bool Initialize(const std::string& app_name, const std::string& desired_bridge_v
         GetWindowPositionForDisplay(display_id, &info.window_position.x, &info.window_position.y);
     }
 
-    void PopulateDisplayInfos(std::vector<DisplayInfo>& displayInfos) {
+    std::vector<unsigned long> QueryDisplayIds() {
+        std::vector<unsigned long> display_ids;
+
         int display_count = 0;
         GetDisplays(&display_count, nullptr);
-
         if (display_count > 0) {
-            std::vector<unsigned long> display_ids(display_count);
+            display_ids.resize(display_count);
             GetDisplays(&display_count, display_ids.data());
+            display_ids.resize(display_count);
+        }
+
+        return display_ids;
+    }
+
+    std::wstring QueryDisplaySerial(unsigned long display_id) {
+        std::wstring serial;
+
+        int serial_count = 0;
+        GetDeviceSerialForDisplay(display_id, &serial_count, nullptr);
+        if (serial_count > 0) {
+            serial.resize(serial_count);
+            GetDeviceSerialForDisplay(display_id, &serial_count, serial.data());
+        }
+
+        return serial;
+    }
+
+    void PopulateDisplayInfos(std::vector<DisplayInfo>& displayInfos) {
+        std::vector<unsigned long> display_ids = QueryDisplayIds();
+        displayInfos.reserve(displayInfos.size() + display_ids.size());
+
+        for (auto display_id : display_ids) {
+            displayInfos.emplace_back();
+            PopulateSingleDisplayInfo(display_id, displayInfos.back());
+        }
+    }
+
+    // True when the connected displays (ids and serials) differ from the snapshot.
+    // Costs one GetDisplays pair plus two serial queries per display, instead of the
+    // full per-display metadata walk.
+    bool DisplaySetChanged(const DisplaySnapshot& snapshot) {
+        std::vector<unsigned long> display_ids = QueryDisplayIds();
+        if (display_ids.size() != snapshot.displays.size()) {
+            return true;
+        }
+
+        for (size_t i = 0; i < display_ids.size(); i++) {
+            const DisplayInfo& cached = snapshot.displays[i];
+            if (cached.display_id != display_ids[i] || cached.serial != QueryDisplaySerial(display_ids[i])) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static bool SameDisplayInfo(const DisplayInfo& a, const DisplayInfo& b) {
+        const LKGCalibration& ca = a.calibration;
+        const LKGCalibration& cb = b.calibration;
+        const DefaultQuitSettings& qa = a.default_quilt_settings;
+        const DefaultQuitSettings& qb = b.default_quilt_settings;
+
+        return a.display_id == b.display_id && a.serial == b.serial && a.name == b.name &&
+               a.dimensions.width == b.dimensions.width && a.dimensions.height == b.dimensions.height &&
+               a.hw_enum == b.hw_enum &&
+               ca.center == cb.center && ca.pitch == cb.pitch && ca.slope == cb.slope &&
+               ca.width == cb.width && ca.height == cb.height && ca.dpi == cb.dpi &&
+               ca.flip_x == cb.flip_x && ca.invView == cb.invView && ca.viewcone == cb.viewcone &&
+               ca.fringe == cb.fringe && ca.cell_pattern_mode == cb.cell_pattern_mode &&
+               ca.cells.size() == cb.cells.size() &&
+               (ca.cells.empty() || std::memcmp(ca.cells.data(), cb.cells.data(), ca.cells.size() * sizeof(CalibrationSubpixelCell)) == 0) &&
+               a.viewinv == b.viewinv && a.ri == b.ri && a.bi == b.bi && a.tilt == b.tilt &&
+               a.aspect == b.aspect && a.fringe == b.fringe && a.subp == b.subp &&
+               a.viewcone == b.viewcone && a.center == b.center && a.pitch == b.pitch &&
+               qa.aspect == qb.aspect && qa.quilt_width == qb.quilt_width && qa.quilt_height == qb.quilt_height &&
+               qa.quilt_columns == qb.quilt_columns && qa.quilt_rows == qb.quilt_rows &&
+               a.window_position.x == b.window_position.x && a.window_position.y == b.window_position.y;
+    }
+
+    static bool SameDisplays(const std::vector<DisplayInfo>& a, const std::vector<DisplayInfo>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.size(); i++) {
+            if (!SameDisplayInfo(a[i], b[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Builds a snapshot from live Bridge queries and publishes it. The generation is
+    // only bumped if the content differs from the current snapshot, which matters
+    // when the current one came from the disk cache. The cache file is only encoded
+    // and written when a cache path is set. Call with _displayMutex held.
+    std::shared_ptr<const DisplaySnapshot> PublishDisplaySnapshot(bool* changed = nullptr) {
+        auto snapshot = std::make_shared<DisplaySnapshot>();
+        PopulateDisplayInfos(snapshot->displays);
 
-            for (auto display_id : display_ids) {
-                DisplayInfo info;
-                PopulateSingleDisplayInfo(display_id, info);
-                displayInfos.push_back(info);
+        std::shared_ptr<const DisplaySnapshot> current = std::atomic_load(&_displaySnapshot);
+        bool same = current && SameDisplays(current->displays, snapshot->displays);
+        snapshot->generation = same ? current->generation : ++_displayGeneration;
+
+        if (!_displayCachePath.empty()) {
+            std::string encoded = DisplayCacheCodec::Encode(DisplayCacheVersionKey(), snapshot->displays);
+            if (encoded != _displayCacheWritten && BridgeWriteFileAtomically(_displayCachePath, encoded)) {
+                _displayCacheWritten = std::move(encoded);
             }
         }
+
+        if (changed) {
+            *changed = !same;
+        }
+
+        std::shared_ptr<const DisplaySnapshot> published = std::move(snapshot);
+        std::atomic_store(&_displaySnapshot, published);
+        return published;
+    }
+
+    // Identifies the running Bridge build in the cache file, e.g. "2.6.2" or "2.6.2-beta".
+    std::string DisplayCacheVersionKey() {
+        unsigned long major = 0, minor = 0, build = 0;
+        int postfix_count = 0;
+        if (!GetBridgeVersion(&major, &minor, &build, &postfix_count, nullptr)) {
+            return std::string();
+        }
+
+        std::wstring postfix;
+        if (postfix_count > 0) {
+            postfix.resize(postfix_count);
+            GetBridgeVersion(&major, &minor, &build, &postfix_count, &postfix[0]);
+            postfix.resize(std::wcslen(postfix.c_str()));
+        }
+
+        std::string key = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(build);
+        if (!postfix.empty()) {
+            key += "-" + std::string(postfix.begin(), postfix.end());
+        }
+        return key;
     }
 
 public:
@@ -1699,6 +2061,118 @@ public:
         return displayInfos;
     }
 
+    // Returns the cached display snapshot, building it on first use after Initialize.
+    // This does not talk to Bridge once the snapshot exists, so it is cheap enough to
+    // call every frame; call RefreshDisplaySnapshot to pick up hotplug changes.
+    std::shared_ptr<const DisplaySnapshot> GetDisplaySnapshot() {
+        std::shared_ptr<const DisplaySnapshot> snapshot = std::atomic_load(&_displaySnapshot);
+        if (!snapshot) {
+            std::lock_guard<std::mutex> lock(_displayMutex);
+            snapshot = std::atomic_load(&_displaySnapshot);
+            if (!snapshot) {
+                snapshot = PublishDisplaySnapshot();
+            }
+        }
+        return snapshot;
+    }
+
+    // Re-checks which displays are connected and publishes a new snapshot with the
+    // next generation if the set changed. Returns true when a new snapshot was published.
+    bool RefreshDisplaySnapshot() {
+        std::lock_guard<std::mutex> lock(_displayMutex);
+        std::shared_ptr<const DisplaySnapshot> snapshot = std::atomic_load(&_displaySnapshot);
+        if (snapshot && !DisplaySetChanged(*snapshot)) {
+            return false;
+        }
+
+        PublishDisplaySnapshot();
+        return true;
+    }
+
+    // Generation of the current snapshot, or 0 if none has been built yet.
+    uint64_t GetDisplayGeneration() {
+        std::shared_ptr<const DisplaySnapshot> snapshot = std::atomic_load(&_displaySnapshot);
+        return snapshot ? snapshot->generation : 0;
+    }
+
+    // ------------------------------------------------------------ display cache --
+    // Persists the display list between runs so the first frame does not wait on
+    // the full metadata walk. Typical start-up:
+    //
+    //   controller.SetDisplayCachePath(controller.DefaultDisplayCachePath());
+    //   controller.Initialize(...);
+    //   controller.LoadCachedDisplaySnapshot();            // render from this immediately
+    //   auto check = controller.RevalidateDisplaySnapshotAsync();
+    //
+    // Every live snapshot is written back to the file when its content changed.
+
+    // Next to Bridge's settings.json.
+    std::filesystem::path DefaultDisplayCachePath() {
+        return std::filesystem::path(SettingsPath()).parent_path() / "sdk_display_cache.bin";
+    }
+
+    // An empty path disables the cache.
+    void SetDisplayCachePath(const std::filesystem::path& path) {
+        std::lock_guard<std::mutex> lock(_displayMutex);
+        _displayCachePath = path;
+        _displayCacheWritten.clear();
+    }
+
+    // Publishes the cached display list as the current snapshot, with from_disk_cache
+    // set. Display ids are not stable across runtime restarts, so cached entries are
+    // matched to the connected displays by serial and take their live ids; anything
+    // published here can be passed to InstanceWindowGL. Fails if there is no cache,
+    // it is corrupt, it was written by another Bridge version, or a connected display
+    // is missing from it. Costs one version query, a file read, one GetDisplays pair
+    // and two serial queries per display.
+    bool LoadCachedDisplaySnapshot() {
+        std::lock_guard<std::mutex> lock(_displayMutex);
+        if (_displayCachePath.empty()) {
+            return false;
+        }
+
+        std::string bytes;
+        std::vector<DisplayInfo> cached;
+        if (!DisplayCacheCodec::ReadFile(_displayCachePath, bytes) ||
+            !DisplayCacheCodec::Decode(bytes, DisplayCacheVersionKey(), cached)) {
+            return false;
+        }
+
+        auto snapshot = std::make_shared<DisplaySnapshot>();
+        for (auto display_id : QueryDisplayIds()) {
+            std::wstring serial = QueryDisplaySerial(display_id);
+            auto match = std::find_if(cached.begin(), cached.end(),
+                [&serial](const DisplayInfo& info) { return info.serial == serial; });
+            if (match == cached.end()) {
+                return false;
+            }
+
+            snapshot->displays.push_back(*match);
+            snapshot->displays.back().display_id = display_id;
+        }
+
+        snapshot->generation = ++_displayGeneration;
+        snapshot->from_disk_cache = true;
+        _displayCacheWritten = std::move(bytes);
+
+        std::atomic_store(&_displaySnapshot, std::shared_ptr<const DisplaySnapshot>(std::move(snapshot)));
+        return true;
+    }
+
+    // Re-reads every display from Bridge and publishes the result. Returns true if it
+    // differed from the previous snapshot (which then gets a new generation).
+    bool RevalidateDisplaySnapshot() {
+        std::lock_guard<std::mutex> lock(_displayMutex);
+        bool changed = false;
+        PublishDisplaySnapshot(&changed);
+        return changed;
+    }
+
+    // RevalidateDisplaySnapshot on the async worker pool.
+    std::future<bool> RevalidateDisplaySnapshotAsync(BridgeCancelToken token = BridgeCancelToken()) {
+        return Tasks().Submit([this]() { return RevalidateDisplaySnapshot(); }, token);
+    }
+
     bool IsDisplayDisconnected(const std::wstring& target_serial) {
         int serial_count = 0;
 
@@ -1731,6 +2205,228 @@ public:
     }
 
 };
+
+// Watches for Looking Glass displays being connected or disconnected without
+// putting Bridge calls on the render thread.
+//
+// A background thread calls Controller::RefreshDisplaySnapshot at a fixed interval.
+// When the display set changes it diffs the old and new snapshots, queues one
+// Event per connected or disconnected display, calls the callback (on the monitor
+// thread) and raises a flag. The render loop only has to check ConsumeChange(),
+// which is a single atomic exchange, and can then look at the new snapshot.
+//
+// ConsumeChange and IsConnected are lock-free. IsConnected reads the snapshot
+// through a raw pointer. Replaced snapshots are only freed once no IsConnected call
+// is in progress. GetSnapshot hands out a shared_ptr through std::atomic_load,
+// which libstdc++ implements with a mutex, so keep it off hot paths.
+//
+// Stop the monitor before calling Uninitialize on its Controller.
+class DisplayHotplugMonitor
+{
+public:
+    enum class EventType
+    {
+        Connected,
+        Disconnected
+    };
+
+    struct Event
+    {
+        EventType     type = EventType::Connected;
+        unsigned long display_id = 0;
+        std::wstring  serial;
+    };
+
+    using Callback = std::function<void(const Event&)>;
+
+private:
+    Controller&                            controller;
+    std::chrono::milliseconds              interval;
+    Callback                               callback;
+
+    std::thread                            worker;
+    std::mutex                             wakeMutex;
+    std::condition_variable                wake;
+    bool                                   stopRequested = false;
+
+    std::atomic<bool>                      changed{ false };
+    std::shared_ptr<const DisplaySnapshot> current;
+
+    // current.get() for IsConnected. Snapshots it may still point to are kept in
+    // retired until no reader is counted. Both are only changed on the thread that
+    // publishes.
+    std::atomic<const DisplaySnapshot*>                 published{ nullptr };
+    mutable std::atomic<int>                            readers{ 0 };
+    std::vector<std::shared_ptr<const DisplaySnapshot>> retired;
+
+    std::mutex                             eventMutex;
+    std::vector<Event>                     events;
+
+    void Publish(const std::shared_ptr<const DisplaySnapshot>& previous, const std::shared_ptr<const DisplaySnapshot>& next)
+    {
+        std::vector<Event> diff;
+
+        for (const auto& display : previous->displays)
+        {
+            if (!next->FindBySerial(display.serial))
+            {
+                diff.push_back({ EventType::Disconnected, display.display_id, display.serial });
+            }
+        }
+
+        for (const auto& display : next->displays)
+        {
+            if (!previous->FindBySerial(display.serial))
+            {
+                diff.push_back({ EventType::Connected, display.display_id, display.serial });
+            }
+        }
+
+        retired.push_back(std::atomic_load(&current));
+        std::atomic_store(&current, next);
+        published.store(next.get());
+        Reclaim();
+
+        if (callback)
+        {
+            for (const auto& event : diff)
+            {
+                callback(event);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            events.insert(events.end(), diff.begin(), diff.end());
+        }
+
+        changed.store(true, std::memory_order_release);
+    }
+
+    // A reader that starts after published was replaced can only see the new
+    // snapshot, so with no reader counted every retired one can go. Both sides are
+    // sequentially consistent for this to hold.
+    void Reclaim()
+    {
+        if (!retired.empty() && readers.load() == 0)
+        {
+            retired.clear();
+        }
+    }
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+
+        while (!wake.wait_for(lock, interval, [this] { return stopRequested; }))
+        {
+            lock.unlock();
+
+            std::shared_ptr<const DisplaySnapshot> previous = std::atomic_load(&current);
+            if (controller.RefreshDisplaySnapshot())
+            {
+                Publish(previous, controller.GetDisplaySnapshot());
+            }
+            Reclaim();
+
+            lock.lock();
+        }
+    }
+
+public:
+    explicit DisplayHotplugMonitor(Controller& controller, std::chrono::milliseconds interval = std::chrono::milliseconds(500))
+        : controller(controller), interval(interval)
+    {
+    }
+
+    DisplayHotplugMonitor(const DisplayHotplugMonitor&) = delete;
+    DisplayHotplugMonitor& operator=(const DisplayHotplugMonitor&) = delete;
+
+    ~DisplayHotplugMonitor()
+    {
+        Stop();
+    }
+
+    // The callback runs on the monitor thread. Set it before Start.
+    void SetCallback(Callback cb)
+    {
+        callback = std::move(cb);
+    }
+
+    void SetInterval(std::chrono::milliseconds value)
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        interval = value;
+    }
+
+    bool Start()
+    {
+        if (worker.joinable())
+        {
+            return false;
+        }
+
+        std::shared_ptr<const DisplaySnapshot> snapshot = controller.GetDisplaySnapshot();
+        retired.push_back(std::atomic_load(&current));
+        std::atomic_store(&current, snapshot);
+        published.store(snapshot.get());
+        Reclaim();
+        changed.store(false, std::memory_order_relaxed);
+        stopRequested = false;
+        worker = std::thread(&DisplayHotplugMonitor::Run, this);
+        return true;
+    }
+
+    void Stop()
+    {
+        if (!worker.joinable())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopRequested = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    bool IsRunning() const
+    {
+        return worker.joinable();
+    }
+
+    // Returns true once after each change to the display set.
+    bool ConsumeChange()
+    {
+        return changed.load(std::memory_order_relaxed) && changed.exchange(false, std::memory_order_acquire);
+    }
+
+    // The snapshot the monitor last observed. Not lock-free, see above.
+    std::shared_ptr<const DisplaySnapshot> GetSnapshot() const
+    {
+        return std::atomic_load(&current);
+    }
+
+    bool IsConnected(const std::wstring& serial) const
+    {
+        readers.fetch_add(1);
+        const DisplaySnapshot* snapshot = published.load();
+        bool connected = snapshot && snapshot->FindBySerial(serial) != nullptr;
+        readers.fetch_sub(1);
+        return connected;
+    }
+
+    // Hands over the events queued since the last call, oldest first.
+    std::vector<Event> DrainEvents()
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        std::vector<Event> drained;
+        drained.swap(events);
+        return drained;
+    }
+};
 #ifdef _WIN32
 #pragma warning(default : 4244)
 #endif
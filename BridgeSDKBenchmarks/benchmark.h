@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+// Minimal timing harness shared by the benchmark executables. Each measurement
+// runs the body `iterations` times, repeats that a few times and keeps the
+// fastest run, which is the most stable number on a busy machine.
+namespace bench
+{
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    template<typename Fn>
+    double NanosecondsPerOp(size_t iterations, Fn&& body, int repeats = 5)
+    {
+        double best = 0.0;
+
+        for (int r = 0; r < repeats; r++)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (size_t i = 0; i < iterations; i++)
+            {
+                body(i);
+            }
+
+            auto end = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count() / double(iterations);
+
+            if (r == 0 || ns < best)
+            {
+                best = ns;
+            }
+        }
+
+        return best;
+    }
+
+    inline void Report(const char* name, double nsPerOp)
+    {
+        std::printf("  %-52s %10.2f ns/op\n", name, nsPerOp);
+    }
+}
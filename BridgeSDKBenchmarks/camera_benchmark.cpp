@@ -0,0 +1,410 @@
+// Cost of computing the camera matrices for a whole quilt, per frame.
+//
+// "per view" is what the samples used to do: computeViewProjectionMatrices and
+// getModelMatrix once for every view. "batched" is computeQuiltMatrices plus one
+// getModelMatrix, which is what they do now. Both must produce the same matrices.
+// "shear" is computeQuiltShear, the two matrices a shader needs to derive every
+// view itself; it is checked against projection * view of each view.
+//
+// "cull" tests a set of spheres against the union frustum of the quilt and against
+// every view's frustum; nothing visible in a view may be rejected by the union.
+// The reversed depth modes are checked the same way but not timed.
+//
+// "derived state" is the per-frame cost of the camera distance, offset and base
+// projection on an unchanged camera, and after a setter changed the field of view.
+//
+// The Matrix4 kernels are compared with plain scalar loops. Only inverse has a
+// SIMD path; camera_benchmark_scalar is the same program built with
+// LKG_CAMERA_NO_SIMD.
+
+#include "benchmark.h"
+
+#include <LKGCamera.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct QuiltLayout
+    {
+        const char* name;
+        int vx;
+        int vy;
+    };
+
+    bool SameMatrix(const Matrix4& a, const Matrix4& b)
+    {
+        return std::memcmp(a.m, b.m, sizeof(a.m)) == 0;
+    }
+
+    bool NearMatrix(const Matrix4& a, const Matrix4& b, float tolerance)
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            if (!(std::fabs(a.m[i] - b.m[i]) <= tolerance))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Matrix4::operator* as it was before it skipped zeroing its result.
+    Matrix4 ScalarMultiply(const Matrix4& a, const Matrix4& b)
+    {
+        Matrix4 result;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                result.m[i * 4 + j] = a.m[i * 4 + 0] * b.m[0 * 4 + j] +
+                    a.m[i * 4 + 1] * b.m[1 * 4 + j] +
+                    a.m[i * 4 + 2] * b.m[2 * 4 + j] +
+                    a.m[i * 4 + 3] * b.m[3 * 4 + j];
+            }
+        }
+        return result;
+    }
+
+    Matrix4 ScalarTranspose(const Matrix4& a)
+    {
+        Matrix4 result;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                result.m[j * 4 + i] = a.m[i * 4 + j];
+            }
+        }
+        return result;
+    }
+
+    struct Sphere
+    {
+        Vector3 center;
+        float radius;
+    };
+
+    // Deterministic spread of spheres around and well beyond the focal plane.
+    std::vector<Sphere> MakeSpheres(size_t count, float radius)
+    {
+        std::vector<Sphere> spheres(count);
+        uint32_t state = 12345;
+        auto next = [&state](float range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (float(state >> 8) / float(1 << 24) * 2.0f - 1.0f) * range;
+        };
+
+        for (auto& sphere : spheres)
+        {
+            sphere.center = Vector3(next(40.0f), next(20.0f), next(60.0f));
+            sphere.radius = radius;
+        }
+        return spheres;
+    }
+
+    // Checks the union and per-view frusta for one layout and, if report is set,
+    // what culling the sphere set costs each way. Returns false on a mismatch.
+    bool RunCulling(const LKGCamera& camera, const QuiltLayout& layout, float offset_mult, float focus, bool report)
+    {
+        int totalViews = layout.vx * layout.vy;
+        LKGCamera::Frustum unionFrustum = camera.computeQuiltUnionFrustum(layout.vx, layout.vy, true, offset_mult, focus);
+        LKGCamera::QuiltFrustums frustums;
+        camera.computeQuiltFrustums(layout.vx, layout.vy, true, offset_mult, focus, frustums);
+
+        LKGCamera::QuiltMatrices quilt;
+        camera.computeQuiltMatrices(layout.vx, layout.vy, true, offset_mult, focus, quilt);
+        for (int v = 0; v < totalViews; v++)
+        {
+            LKGCamera::Frustum direct = LKGCamera::Frustum::fromViewProjection(quilt.view[v] * quilt.projection[v], camera.getDepthMode());
+            for (int plane = 0; plane < 6; plane++)
+            {
+                int index = plane * totalViews + v;
+                float stored[4] = { frustums.a[index], frustums.b[index], frustums.c[index], frustums.d[index] };
+                for (int c = 0; c < 4; c++)
+                {
+                    if (!(std::fabs(stored[c] - direct.planes[plane][c]) <= 1e-3f * (1.0f + std::fabs(direct.planes[plane][c]))))
+                    {
+                        std::printf("%s: view %d plane %d differs from its projection * view\n", layout.name, v, plane);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        std::vector<unsigned char> visible(totalViews);
+        for (float radius : { 0.0f, 0.5f })
+        {
+            for (const auto& sphere : MakeSpheres(20000, radius))
+            {
+                frustums.intersectSphere(sphere.center, sphere.radius, visible.data());
+                bool anyView = false;
+                for (int v = 0; v < totalViews; v++)
+                {
+                    anyView |= visible[v] != 0;
+                }
+
+                if (anyView && !unionFrustum.intersectsSphere(sphere.center, sphere.radius))
+                {
+                    std::printf("%s: union frustum rejects a sphere that a view can see\n", layout.name);
+                    return false;
+                }
+            }
+        }
+
+        if (!report)
+        {
+            return true;
+        }
+
+        std::vector<Sphere> spheres = MakeSpheres(4096, 0.5f);
+
+        double unionCull = bench::NanosecondsPerOp(200, [&](size_t)
+        {
+            size_t kept = 0;
+            for (const auto& sphere : spheres)
+            {
+                kept += unionFrustum.intersectsSphere(sphere.center, sphere.radius);
+            }
+            bench::DoNotOptimize(kept);
+        });
+
+        double perViewCull = bench::NanosecondsPerOp(200, [&](size_t)
+        {
+            for (const auto& sphere : spheres)
+            {
+                frustums.intersectSphere(sphere.center, sphere.radius, visible.data());
+                bench::DoNotOptimize(visible.data());
+            }
+        });
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%-18s union, 4096 spheres", layout.name);
+        bench::Report(label, unionCull);
+        std::snprintf(label, sizeof(label), "%-18s per view, 4096 spheres", layout.name);
+        bench::Report(label, perViewCull);
+        return true;
+    }
+
+    // Checks that setters only bump the version on a real change and reports what
+    // the derived state costs with and without a change. Returns false on a mismatch.
+    bool RunDerivedState(LKGCamera camera)
+    {
+        uint64_t version = camera.getVersion();
+        camera.setFov(camera.getFov());
+        if (camera.getVersion() != version)
+        {
+            std::printf("setting an unchanged field bumped the camera version\n");
+            return false;
+        }
+
+        LKGCamera fresh(camera.getSize(), camera.getCenter(), camera.getUp(), camera.getFov() + 1.0f,
+            camera.getViewcone(), camera.getAspectRatio(), camera.getNearPlane(), camera.getFarPlane());
+        camera.setFov(camera.getFov() + 1.0f);
+        if (camera.getVersion() == version ||
+            camera.getCameraOffset() != fresh.getCameraOffset() ||
+            !SameMatrix(camera.getProjectionMatrix(), fresh.getProjectionMatrix()))
+        {
+            std::printf("derived camera state was not refreshed after a setter\n");
+            return false;
+        }
+
+        const size_t iterations = 2000000;
+
+        double unchanged = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            bench::DoNotOptimize(camera.getCameraOffset());
+            bench::DoNotOptimize(camera.getProjectionMatrix());
+        });
+
+        float fov = camera.getFov();
+        double changed = bench::NanosecondsPerOp(iterations, [&](size_t i)
+        {
+            camera.setFov(fov + float(i & 1));
+            bench::DoNotOptimize(camera.getCameraOffset());
+            bench::DoNotOptimize(camera.getProjectionMatrix());
+        });
+
+        std::printf("Camera derived state, per frame\n");
+        bench::Report("unchanged camera", unchanged);
+        bench::Report("after setFov", changed);
+        return true;
+    }
+
+    // Checks the kernels against the scalar loops and reports their cost. Returns
+    // false on a mismatch.
+    bool RunMatrixKernels(const LKGCamera& camera)
+    {
+        Matrix4 model = camera.getModelMatrix(0.3f, -0.7f);
+        Matrix4 projection = camera.getProjectionMatrix();
+
+        if (!NearMatrix(model * projection, ScalarMultiply(model, projection), 1e-5f) ||
+            !SameMatrix(model.transposed(), ScalarTranspose(model)) ||
+            !NearMatrix(model * model.inverse(), Matrix4::Identity(), 1e-5f) ||
+            !NearMatrix(projection * projection.inverse(), Matrix4::Identity(), 1e-4f))
+        {
+            std::printf("Matrix4 kernels disagree with the scalar reference\n");
+            return false;
+        }
+
+        const size_t iterations = 2000000;
+
+        double scalarMul = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            bench::DoNotOptimize(model);
+            bench::DoNotOptimize(ScalarMultiply(model, projection));
+        });
+
+        double mul = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            bench::DoNotOptimize(model);
+            bench::DoNotOptimize(model * projection);
+        });
+
+        double transpose = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            model = model.transposed();
+            bench::DoNotOptimize(model);
+        });
+
+        double inverse = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            projection = projection.inverse();
+            bench::DoNotOptimize(projection);
+        });
+
+#if defined(LKG_CAMERA_SSE)
+        std::printf("Matrix4 kernels (SSE inverse)\n");
+#elif defined(LKG_CAMERA_NEON)
+        std::printf("Matrix4 kernels (NEON inverse)\n");
+#else
+        std::printf("Matrix4 kernels (scalar)\n");
+#endif
+        bench::Report("operator* scalar loop", scalarMul);
+        bench::Report("operator*", mul);
+        bench::Report("transposed", transpose);
+        bench::Report("inverse", inverse);
+        return true;
+    }
+}
+
+int main()
+{
+    const QuiltLayout layouts[] =
+    {
+        { "45 views (5x9)",   5,  9 },
+        { "48 views (8x6)",   8,  6 },
+        { "100 views (10x10)", 10, 10 },
+    };
+
+    LKGCamera camera(10.0f, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f), 14.0f, 40.0f, 0.75f, 0.1f, 100.0f);
+    const float offset_mult = 1.0f;
+    const float focus = -0.5f;
+    const size_t iterations = 20000;
+
+    if (!RunDerivedState(camera) || !RunMatrixKernels(camera))
+    {
+        return 1;
+    }
+
+    std::printf("Quilt camera matrices, per frame\n");
+
+    for (const auto& layout : layouts)
+    {
+        int totalViews = layout.vx * layout.vy;
+        std::vector<Matrix4> views(totalViews);
+        std::vector<Matrix4> projections(totalViews);
+        std::vector<Matrix4> models(totalViews);
+        LKGCamera::QuiltMatrices quilt;
+
+        double perView = bench::NanosecondsPerOp(iterations, [&](size_t i)
+        {
+            float angle = float(i) * 0.001f;
+            for (int v = 0; v < totalViews; v++)
+            {
+                float normalizedView = static_cast<float>(v) / static_cast<float>(totalViews - 1);
+                camera.computeViewProjectionMatrices(normalizedView, true, offset_mult, focus, views[v], projections[v]);
+                models[v] = camera.getModelMatrix(angle, angle);
+            }
+            bench::DoNotOptimize(views.data());
+            bench::DoNotOptimize(models.data());
+        });
+
+        double batched = bench::NanosecondsPerOp(iterations, [&](size_t i)
+        {
+            float angle = float(i) * 0.001f;
+            models[0] = camera.getModelMatrix(angle, angle);
+            camera.computeQuiltMatrices(layout.vx, layout.vy, true, offset_mult, focus, quilt);
+            bench::DoNotOptimize(quilt.view.data());
+            bench::DoNotOptimize(models.data());
+        });
+
+        for (int v = 0; v < totalViews; v++)
+        {
+            float normalizedView = static_cast<float>(v) / static_cast<float>(totalViews - 1);
+            camera.computeViewProjectionMatrices(normalizedView, true, offset_mult, focus, views[v], projections[v]);
+            if (!SameMatrix(views[v], quilt.view[v]) || !SameMatrix(projections[v], quilt.projection[v]))
+            {
+                std::printf("%s: view %d differs from computeViewProjectionMatrices\n", layout.name, v);
+                return 1;
+            }
+        }
+
+        double shear = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            LKGCamera::QuiltShear quiltShear;
+            camera.computeQuiltShear(layout.vx, layout.vy, true, offset_mult, focus, quiltShear);
+            bench::DoNotOptimize(quiltShear);
+        });
+
+        LKGCamera::QuiltShear quiltShear;
+        camera.computeQuiltShear(layout.vx, layout.vy, true, offset_mult, focus, quiltShear);
+        for (int v = 0; v < totalViews; v++)
+        {
+            float d = quiltShear.firstView + float(v) * quiltShear.viewStep;
+            Matrix4 derived;
+            for (int i = 0; i < 16; i++)
+            {
+                derived.m[i] = quiltShear.centerViewProjection.m[i] + d * quiltShear.shear.m[i];
+            }
+
+            if (!NearMatrix(derived, views[v] * projections[v], 1e-4f))
+            {
+                std::printf("%s: view %d differs from the shear-factored transform\n", layout.name, v);
+                return 1;
+            }
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%-18s per view", layout.name);
+        bench::Report(label, perView);
+        std::snprintf(label, sizeof(label), "%-18s batched", layout.name);
+        bench::Report(label, batched);
+        std::snprintf(label, sizeof(label), "%-18s shear", layout.name);
+        bench::Report(label, shear);
+    }
+
+    std::printf("Quilt frustum culling\n");
+    for (const auto& layout : layouts)
+    {
+        if (!RunCulling(camera, layout, offset_mult, focus, true))
+        {
+            return 1;
+        }
+    }
+
+    for (auto mode : { LKGCamera::DepthMode::ReversedZ, LKGCamera::DepthMode::ReversedInfiniteZ })
+    {
+        LKGCamera reversed = camera;
+        reversed.setDepthMode(mode);
+        if (!RunCulling(reversed, layouts[1], offset_mult, focus, false))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Hammers one Controller from many threads at once against the loopback runtime.
+//
+// Render threads issue the per-frame calls (DrawInteropQuiltTextureGL,
+// GetOffscreenWindowTextureGL) while metadata threads walk the display list,
+// snapshots and window data, async threads keep the Controller's worker pool
+// busy, and a DisplayHotplugMonitor polls in the background.
+// Every call's result is checked. Between rounds all threads are joined and the
+// runtime is unloaded and loaded again, which is the quiescence Controller
+// requires around lifecycle calls.
+//
+// Build with -DBRIDGE_BENCHMARKS_TSAN=ON to run it under ThreadSanitizer.
+//
+//   controller_stress [runtime dir] [seconds per round] [threads] [rounds]
+
+#include "benchmark.h"
+#include "loopback_controller.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class StressController : public bench::LoopbackController
+    {
+    public:
+        void Unload()
+        {
+            CloseRuntime();
+        }
+    };
+
+    struct Counters
+    {
+        std::atomic<uint64_t> calls{ 0 };
+        std::atomic<uint64_t> failures{ 0 };
+    };
+
+    void Check(Counters& counters, bool ok)
+    {
+        counters.calls.fetch_add(1, std::memory_order_relaxed);
+        if (!ok)
+        {
+            counters.failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void RenderThread(Controller& controller, WINDOW_HANDLE wnd, const std::atomic<bool>& stop, Counters& counters)
+    {
+        unsigned long long frame = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            frame++;
+            Check(counters, controller.DrawInteropQuiltTextureGL(wnd, frame, PixelFormats::RGBA, 3360, 3360, 8, 6, 0.75f, 1.0f));
+
+            unsigned long long texture = 0;
+            PixelFormats format = PixelFormats::NoFormat;
+            unsigned long width = 0, height = 0;
+            Check(counters, controller.GetOffscreenWindowTextureGL(wnd, &texture, &format, &width, &height) &&
+                            texture != 0 && format == PixelFormats::RGBA && width != 0 && height != 0);
+        }
+    }
+
+    void MetadataThread(Controller& controller, WINDOW_HANDLE wnd, size_t displays, const std::atomic<bool>& stop, Counters& counters)
+    {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            std::vector<DisplayInfo> list = controller.GetDisplayInfoList();
+            Check(counters, list.size() == displays);
+
+            std::shared_ptr<const DisplaySnapshot> snapshot = controller.GetDisplaySnapshot();
+            Check(counters, snapshot && snapshot->displays.size() == displays &&
+                            (displays == 0 || snapshot->FindBySerial(list[0].serial) != nullptr));
+
+            // nothing is hotplugged, so a refresh must never publish a new generation
+            Check(counters, !controller.RefreshDisplaySnapshot());
+
+            BridgeWindowData data = controller.GetWindowData(wnd);
+            Check(counters, data.wnd == wnd && data.vx == 8 && data.vy == 6 && data.view_width == 3360 / 8);
+        }
+    }
+
+    // Rejected async calls (queue full) are expected under load and not failures.
+    void AsyncThread(Controller& controller, WINDOW_HANDLE wnd, size_t displays, const std::atomic<bool>& stop, Counters& counters)
+    {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            std::future<std::vector<DisplayInfo>> list = controller.GetDisplayInfoListAsync();
+            std::future<bool> quilt = controller.QuiltifyRGBDAsync(wnd, 8, 6, 48, 0.75f, 1.0f, 1.0f, 14.0f, 0.0f, 0.0f,
+                0, 0, 0, 1.0f, 0.0f, 0.0f, L"input.png", L"output.png");
+
+            try
+            {
+                Check(counters, list.get().size() == displays);
+            }
+            catch (const BridgeTaskCancelled&)
+            {
+            }
+
+            try
+            {
+                Check(counters, quilt.get());
+            }
+            catch (const BridgeTaskCancelled&)
+            {
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path runtimeDir = argc > 1 ? argv[1] : LOOPBACK_RUNTIME_DIR;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    unsigned threads = argc > 3 ? unsigned(std::max(2, std::atoi(argv[3]))) : std::max(4u, std::thread::hardware_concurrency());
+    int rounds = argc > 4 ? std::max(1, std::atoi(argv[4])) : 3;
+
+    StressController controller;
+    Counters render;
+    Counters metadata;
+    Counters async;
+    uint64_t generation = 0;
+
+    std::printf("Controller stress, %u threads, %d round(s) of %.1f s (%s)\n", threads, rounds, seconds, runtimeDir.string().c_str());
+
+    for (int round = 0; round < rounds; round++)
+    {
+        if (!controller.Load(runtimeDir))
+        {
+            std::printf("failed to load loopback runtime from %s\n", runtimeDir.string().c_str());
+            return 1;
+        }
+
+        std::shared_ptr<const DisplaySnapshot> snapshot = controller.GetDisplaySnapshot();
+        if (snapshot->displays.empty() || snapshot->generation <= generation)
+        {
+            std::printf("round %d: expected a new snapshot with at least one display\n", round);
+            return 1;
+        }
+        generation = snapshot->generation;
+
+        const size_t displays = snapshot->displays.size();
+        const WINDOW_HANDLE wnd = 1;
+
+        std::atomic<bool> stop{ false };
+        std::vector<std::thread> workers;
+
+        DisplayHotplugMonitor monitor(controller, std::chrono::milliseconds(1));
+        monitor.Start();
+
+        for (unsigned i = 0; i < threads; i++)
+        {
+            if (i % 2 == 0)
+            {
+                workers.emplace_back(RenderThread, std::ref(controller), wnd, std::cref(stop), std::ref(render));
+            }
+            else if (i % 4 == 3)
+            {
+                workers.emplace_back(AsyncThread, std::ref(controller), wnd, displays, std::cref(stop), std::ref(async));
+            }
+            else
+            {
+                workers.emplace_back(MetadataThread, std::ref(controller), wnd, displays, std::cref(stop), std::ref(metadata));
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop.store(true);
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        monitor.Stop();
+
+        if (monitor.ConsumeChange() || !monitor.DrainEvents().empty())
+        {
+            std::printf("round %d: hotplug monitor reported a change that did not happen\n", round);
+            return 1;
+        }
+
+        controller.Unload();
+    }
+
+    std::printf("  %-24s %14llu calls %10llu failed\n", "render threads",
+        (unsigned long long)render.calls.load(), (unsigned long long)render.failures.load());
+    std::printf("  %-24s %14llu calls %10llu failed\n", "metadata threads",
+        (unsigned long long)metadata.calls.load(), (unsigned long long)metadata.failures.load());
+    std::printf("  %-24s %14llu calls %10llu failed\n", "async threads",
+        (unsigned long long)async.calls.load(), (unsigned long long)async.failures.load());
+
+    bool ok = render.failures.load() == 0 && metadata.failures.load() == 0 && async.failures.load() == 0;
+    std::printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
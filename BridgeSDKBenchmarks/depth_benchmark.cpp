@@ -0,0 +1,147 @@
+// Memory and precision of the quilt depth buffer for each LKGCamera::DepthMode and
+// depth format. Nothing here touches a GPU: precision is simulated by running eye
+// depths through the camera's projection in float and quantizing them the way the
+// depth buffer stores them, and bandwidth is an estimate from the buffer size.
+//
+// "resolvable" is the smallest eye-space separation, in scene units, that still
+// lands two surfaces in different depth values (worst case around that distance).
+// Larger means more z-fighting.
+
+#include <LKGCamera.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    struct DepthFormat
+    {
+        const char* name;
+        int         bits;          // 0 for float
+        int         bytesPerTexel; // as allocated; 24-bit depth is padded to 32 bits on most GPUs
+    };
+
+    const DepthFormat Depth16 = { "DEPTH_COMPONENT16", 16, 2 };
+    const DepthFormat Depth24 = { "DEPTH_COMPONENT24", 24, 4 };
+    const DepthFormat Depth32 = { "DEPTH_COMPONENT32", 32, 4 };
+    const DepthFormat Depth32F = { "DEPTH_COMPONENT32F", 0, 4 };
+
+    struct Config
+    {
+        LKGCamera::DepthMode mode;
+        const char*          modeName;
+        DepthFormat          format;
+    };
+
+    // Depth value as stored, for a point at eyeDistance in front of the camera.
+    uint64_t StoredDepth(const Matrix4& projection, LKGCamera::DepthMode mode, const DepthFormat& format, float eyeDistance)
+    {
+        float zEye = -eyeDistance;
+        float zClip = projection[10] * zEye + projection[14];
+        float wClip = -zEye;
+        float zNdc = zClip / wClip;
+
+        // glDepthRange(0, 1); the reversed modes use GL_ZERO_TO_ONE clip depth.
+        float window = mode == LKGCamera::DepthMode::Standard ? zNdc * 0.5f + 0.5f : zNdc;
+        window = std::fmin(std::fmax(window, 0.0f), 1.0f);
+
+        if (format.bits == 0)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &window, sizeof(bits));
+            return bits;
+        }
+
+        double scale = std::ldexp(1.0, format.bits) - 1.0;
+        return uint64_t(std::llround(double(window) * scale));
+    }
+
+    // Worst case over a few starting points just beyond eyeDistance.
+    float Resolvable(const Matrix4& projection, const Config& config, float eyeDistance)
+    {
+        float worst = 0.0f;
+        for (int sample = 0; sample < 32; sample++)
+        {
+            float start = eyeDistance * (1.0f + 0.0005f * float(sample));
+            uint64_t base = StoredDepth(projection, config.mode, config.format, start);
+
+            float low = 0.0f;
+            float high = start * 1e-7f;
+            while (StoredDepth(projection, config.mode, config.format, start + high) == base && high < start)
+            {
+                low = high;
+                high *= 2.0f;
+            }
+            for (int i = 0; i < 40; i++)
+            {
+                float mid = 0.5f * (low + high);
+                if (StoredDepth(projection, config.mode, config.format, start + mid) == base)
+                {
+                    low = mid;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+
+            worst = std::fmax(worst, high);
+        }
+        return worst;
+    }
+}
+
+int main()
+{
+    // The samples' camera: the focal plane sits at getCameraDistance().
+    LKGCamera camera(10.0f, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f), 14.0f, 40.0f, 0.75f, 0.1f, 100.0f);
+    const float focal = camera.getCameraDistance();
+
+    const Config configs[] =
+    {
+        { LKGCamera::DepthMode::Standard,          "standard",         Depth32 },
+        { LKGCamera::DepthMode::Standard,          "standard",         Depth24 },
+        { LKGCamera::DepthMode::Standard,          "standard",         Depth16 },
+        { LKGCamera::DepthMode::Standard,          "standard",         Depth32F },
+        { LKGCamera::DepthMode::ReversedZ,         "reversed",         Depth24 },
+        { LKGCamera::DepthMode::ReversedZ,         "reversed",         Depth16 },
+        { LKGCamera::DepthMode::ReversedZ,         "reversed",         Depth32F },
+        { LKGCamera::DepthMode::ReversedInfiniteZ, "reversed infinite", Depth32F },
+    };
+
+    std::printf("Depth precision, near %.1f far %.1f, focal plane at %.1f (resolvable separation)\n",
+        camera.getNearPlane(), camera.getFarPlane(), focal);
+    std::printf("  %-18s %-20s %12s %12s %12s\n", "mode", "format", "at 1", "at focal", "at 95");
+
+    for (const Config& config : configs)
+    {
+        camera.setDepthMode(config.mode);
+        Matrix4 projection = camera.getProjectionMatrix();
+        std::printf("  %-18s %-20s %12.3g %12.3g %12.3g\n", config.modeName, config.format.name,
+            Resolvable(projection, config, 1.0f), Resolvable(projection, config, focal), Resolvable(projection, config, 95.0f));
+    }
+
+    const struct { const char* name; int width; int height; } quilts[] =
+    {
+        { "3360x3360", 3360, 3360 },
+        { "4096x4096", 4096, 4096 },
+        { "8192x8192", 8192, 8192 },
+    };
+    const DepthFormat formats[] = { Depth32, Depth24, Depth16, Depth32F };
+
+    // Clear plus one depth test read and write per pixel, at 60 frames per second.
+    std::printf("Quilt depth buffer memory, and estimated depth traffic at 60 fps with no overdraw\n");
+    for (const auto& quilt : quilts)
+    {
+        for (const DepthFormat& format : formats)
+        {
+            double bytes = double(quilt.width) * double(quilt.height) * format.bytesPerTexel;
+            std::printf("  %-10s %-20s %8.1f MiB %8.2f GB/s\n", quilt.name, format.name,
+                bytes / (1024.0 * 1024.0), bytes * 3.0 * 60.0 / 1e9);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Per-call overhead of the Controller wrappers against the loopback runtime.
+//
+// "legacy lookup" reproduces the dispatch the Controller used before entry points
+// were bound up front: build a path + name key, look it up in a std::map and cast.
+// "bound table" is the current Controller path: one load from the typed function
+// table and an indirect call.
+
+#include "benchmark.h"
+#include "loopback_controller.h"
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace
+{
+    class LegacyLoader
+    {
+    private:
+        std::map<std::string, void*> functionCache;
+
+    public:
+        template<typename T>
+        T LoadFunction(const std::string& path, const std::string& functionName)
+        {
+            auto key = path + functionName;
+            auto it = functionCache.find(key);
+            if (it != functionCache.end())
+            {
+                return reinterpret_cast<T>(it->second);
+            }
+
+#ifdef _WIN32
+            void* funcPtr = reinterpret_cast<void*>(GetProcAddress(LoadLibraryA(path.c_str()), functionName.c_str()));
+#else
+            void* funcPtr = dlsym(dlopen(path.c_str(), RTLD_LAZY), functionName.c_str());
+#endif
+            if (!funcPtr)
+            {
+                return nullptr;
+            }
+
+            functionCache[key] = funcPtr;
+            return reinterpret_cast<T>(funcPtr);
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path runtimeDir = argc > 1 ? argv[1] : LOOPBACK_RUNTIME_DIR;
+    std::string libraryPath = (runtimeDir / bench::RuntimeLibraryName).string();
+
+    bench::LoopbackController controller;
+    if (!controller.Load(runtimeDir))
+    {
+        std::printf("failed to load loopback runtime from %s\n", libraryPath.c_str());
+        return 1;
+    }
+
+    LegacyLoader legacy;
+    const size_t iterations = 2000000;
+    const WINDOW_HANDLE wnd = 1;
+
+    using DrawFunc = bool(*)(WINDOW_HANDLE, unsigned long long, PixelFormats, unsigned long, unsigned long, unsigned long, unsigned long, float, float);
+    using TextureFunc = bool(*)(WINDOW_HANDLE, unsigned long long*, PixelFormats*, unsigned long*, unsigned long*);
+
+    std::printf("Controller dispatch overhead (%s)\n", libraryPath.c_str());
+
+    double legacyDraw = bench::NanosecondsPerOp(iterations, [&](size_t i)
+    {
+        auto func = legacy.LoadFunction<DrawFunc>(libraryPath, "draw_interop_quilt_texture_gl");
+        bench::DoNotOptimize(func(wnd, i + 1, PixelFormats::RGBA, 4096, 4096, 8, 6, 0.75f, 1.0f));
+    });
+
+    double boundDraw = bench::NanosecondsPerOp(iterations, [&](size_t i)
+    {
+        bench::DoNotOptimize(controller.DrawInteropQuiltTextureGL(wnd, i + 1, PixelFormats::RGBA, 4096, 4096, 8, 6, 0.75f, 1.0f));
+    });
+
+    double legacyTexture = bench::NanosecondsPerOp(iterations, [&](size_t)
+    {
+        unsigned long long texture = 0;
+        PixelFormats format = PixelFormats::NoFormat;
+        unsigned long width = 0, height = 0;
+        auto func = legacy.LoadFunction<TextureFunc>(libraryPath, "get_offscreen_window_texture_gl");
+        bench::DoNotOptimize(func(wnd, &texture, &format, &width, &height));
+    });
+
+    double boundTexture = bench::NanosecondsPerOp(iterations, [&](size_t)
+    {
+        unsigned long long texture = 0;
+        PixelFormats format = PixelFormats::NoFormat;
+        unsigned long width = 0, height = 0;
+        bench::DoNotOptimize(controller.GetOffscreenWindowTextureGL(wnd, &texture, &format, &width, &height));
+    });
+
+    bench::Report("DrawInteropQuiltTextureGL     legacy lookup", legacyDraw);
+    bench::Report("DrawInteropQuiltTextureGL     bound table", boundDraw);
+    bench::Report("GetOffscreenWindowTextureGL   legacy lookup", legacyTexture);
+    bench::Report("GetOffscreenWindowTextureGL   bound table", boundTexture);
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Cost of reading display metadata through the Controller against the loopback runtime.
+//
+// "GetDisplayInfoList" re-queries every field of every display from Bridge.
+// "GetDisplaySnapshot" returns the cached snapshot, which is what per-frame UI and
+// render code should use. "RefreshDisplaySnapshot" is the hotplug check that decides
+// whether a new snapshot has to be built.
+//
+// "LoadCachedDisplaySnapshot" is the start-up path that reads the display list from
+// the on-disk cache instead of Bridge.
+//
+// The last pair compares the old per-frame IsDisplayDisconnected poll with the
+// atomic check a render loop does when a DisplayHotplugMonitor is running. The
+// monitor's lock-free IsConnected is timed against its GetSnapshot, which goes
+// through std::atomic_load on a shared_ptr.
+
+#include "benchmark.h"
+#include "loopback_controller.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path runtimeDir = argc > 1 ? argv[1] : LOOPBACK_RUNTIME_DIR;
+    std::string libraryPath = (runtimeDir / bench::RuntimeLibraryName).string();
+
+    bench::LoopbackController controller;
+    if (!controller.Load(runtimeDir))
+    {
+        std::printf("failed to load loopback runtime from %s\n", libraryPath.c_str());
+        return 1;
+    }
+
+    const size_t displays = controller.GetDisplaySnapshot()->displays.size();
+    std::printf("Display metadata queries, %zu display(s) (%s)\n", displays, libraryPath.c_str());
+
+    double list = bench::NanosecondsPerOp(20000, [&](size_t)
+    {
+        bench::DoNotOptimize(controller.GetDisplayInfoList().size());
+    });
+
+    double snapshot = bench::NanosecondsPerOp(2000000, [&](size_t)
+    {
+        bench::DoNotOptimize(controller.GetDisplaySnapshot()->generation);
+    });
+
+    double refresh = bench::NanosecondsPerOp(20000, [&](size_t)
+    {
+        bench::DoNotOptimize(controller.RefreshDisplaySnapshot());
+    });
+
+    const std::wstring serial = controller.GetDisplaySnapshot()->displays.empty() ? L"" : controller.GetDisplaySnapshot()->displays[0].serial;
+
+    double poll = bench::NanosecondsPerOp(20000, [&](size_t)
+    {
+        bench::DoNotOptimize(controller.IsDisplayDisconnected(serial));
+    });
+
+    std::filesystem::path cachePath = std::filesystem::temp_directory_path() / "bridge_display_benchmark.bin";
+    controller.SetDisplayCachePath(cachePath);
+    bool revalidated = controller.RevalidateDisplaySnapshot();
+    bench::DoNotOptimize(revalidated);
+
+    double cached = bench::NanosecondsPerOp(20000, [&](size_t)
+    {
+        bench::DoNotOptimize(controller.LoadCachedDisplaySnapshot());
+    });
+
+    bool loaded = controller.LoadCachedDisplaySnapshot() &&
+                  controller.GetDisplaySnapshot()->from_disk_cache &&
+                  !controller.RevalidateDisplaySnapshot();
+
+    controller.SetDisplayCachePath(std::filesystem::path());
+    std::filesystem::remove(cachePath);
+
+    if (!loaded)
+    {
+        std::printf("display cache round trip failed\n");
+        return 1;
+    }
+
+    DisplayHotplugMonitor monitor(controller, std::chrono::milliseconds(100));
+    monitor.Start();
+
+    double consume = bench::NanosecondsPerOp(2000000, [&](size_t)
+    {
+        bench::DoNotOptimize(monitor.ConsumeChange());
+    });
+
+    bool connected = true;
+    double isConnected = bench::NanosecondsPerOp(2000000, [&](size_t)
+    {
+        connected = monitor.IsConnected(serial) && connected;
+    });
+
+    double monitorSnapshot = bench::NanosecondsPerOp(2000000, [&](size_t)
+    {
+        bench::DoNotOptimize(monitor.GetSnapshot());
+    });
+
+    monitor.Stop();
+
+    bench::Report("GetDisplayInfoList", list);
+    bench::Report("GetDisplaySnapshot", snapshot);
+    bench::Report("RefreshDisplaySnapshot (no change)", refresh);
+    bench::Report("LoadCachedDisplaySnapshot (disk)", cached);
+    bench::Report("IsDisplayDisconnected (per-frame poll)", poll);
+    bench::Report("DisplayHotplugMonitor::ConsumeChange", consume);
+    bench::Report("DisplayHotplugMonitor::IsConnected", isConnected);
+    bench::Report("DisplayHotplugMonitor::GetSnapshot", monitorSnapshot);
+
+    if (!connected)
+    {
+        std::printf("DisplayHotplugMonitor::IsConnected lost a connected display\n");
+        return 1;
+    }
+
+    return 0;
+}
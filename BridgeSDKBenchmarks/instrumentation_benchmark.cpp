@@ -0,0 +1,64 @@
+// Cost of BRIDGE_INSTRUMENTATION on the Controller wrappers, and a sample of the
+// JSON it produces.
+//
+// This file is always built with BRIDGE_INSTRUMENTATION defined; compare its
+// numbers with dispatch_benchmark, which is built without it.
+
+#include "benchmark.h"
+#include "loopback_controller.h"
+
+#include <filesystem>
+#include <string>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path runtimeDir = argc > 1 ? argv[1] : LOOPBACK_RUNTIME_DIR;
+    std::string libraryPath = (runtimeDir / bench::RuntimeLibraryName).string();
+
+    bench::LoopbackController controller;
+    if (!controller.Load(runtimeDir))
+    {
+        std::printf("failed to load loopback runtime from %s\n", libraryPath.c_str());
+        return 1;
+    }
+
+    const size_t iterations = 2000000;
+    const WINDOW_HANDLE wnd = 1;
+
+    std::printf("Instrumented Controller dispatch (%s)\n", libraryPath.c_str());
+
+    double draw = bench::NanosecondsPerOp(iterations, [&](size_t i)
+    {
+        bench::DoNotOptimize(controller.DrawInteropQuiltTextureGL(wnd, i + 1, PixelFormats::RGBA, 4096, 4096, 8, 6, 0.75f, 1.0f));
+    });
+
+    double texture = bench::NanosecondsPerOp(iterations, [&](size_t)
+    {
+        unsigned long long tex = 0;
+        PixelFormats format = PixelFormats::NoFormat;
+        unsigned long width = 0, height = 0;
+        bench::DoNotOptimize(controller.GetOffscreenWindowTextureGL(wnd, &tex, &format, &width, &height));
+    });
+
+    bench::Report("DrawInteropQuiltTextureGL     instrumented", draw);
+    bench::Report("GetOffscreenWindowTextureGL   instrumented", texture);
+
+    // a second thread shows up in the same per entry point totals
+    controller.ResetInstrumentation();
+    std::thread metadata([&]()
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            controller.GetDisplayInfoList();
+        }
+    });
+    for (int i = 0; i < 100000; i++)
+    {
+        controller.DrawInteropQuiltTextureGL(wnd, i + 1, PixelFormats::RGBA, 4096, 4096, 8, 6, 0.75f, 1.0f);
+    }
+    metadata.join();
+
+    std::printf("%s\n", controller.GetInstrumentationJson().c_str());
+    return 0;
+}
@@ -0,0 +1,369 @@
+// mlc: loopback stand-in for bridge_inproc. It exports the bridge.h C ABI with
+// trivial bodies so the Controller can be loaded and timed without Bridge
+// installed or a Looking Glass display connected.
+//
+// The loopback reports BRIDGE_LOOPBACK_DISPLAYS fake Looking Glass Portrait
+// displays (default 1). The variable is re-read on every get_displays call, so
+// a host process can simulate hotplug by changing it with setenv.
+// Window handles are display_index + 1; no window or GL work is performed.
+
+#include <bridge.h>
+#include <atomic>
+#include <cstdlib>
+#include <cwchar>
+
+namespace
+{
+    const wchar_t LoopbackName[]   = L"Looking Glass Portrait (loopback)";
+    const wchar_t LoopbackSerial[] = L"LKG-LOOPBACK-000";
+
+    const unsigned long DisplayWidth  = 1536;
+    const unsigned long DisplayHeight = 2048;
+    const int           QuiltWidth    = 3360;
+    const int           QuiltHeight   = 3360;
+    const int           QuiltColumns  = 8;
+    const int           QuiltRows     = 6;
+    const float         Aspect        = 0.75f;
+    const float         Viewcone      = 40.0f;
+    const int           CellCount     = 4;
+
+    // Refreshed from the environment by initialize_bridge and get_displays only,
+    // so the per-frame entry points stay as cheap as the real ones.
+    std::atomic<int> displayCount{ 1 };
+
+    int RefreshDisplayCount()
+    {
+        const char* value = std::getenv("BRIDGE_LOOPBACK_DISPLAYS");
+        int count = value ? std::atoi(value) : 1;
+        count = count < 0 ? 0 : (count > 9 ? 9 : count);
+
+        displayCount.store(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    bool IsDisplay(unsigned long display_index)
+    {
+        return display_index < static_cast<unsigned long>(displayCount.load(std::memory_order_relaxed));
+    }
+
+    bool IsWindow(WINDOW_HANDLE wnd)
+    {
+        return wnd != 0 && IsDisplay(wnd - 1);
+    }
+
+    bool CopyString(const wchar_t* value, wchar_t suffix, int* number_of_wchars, wchar_t* out)
+    {
+        if (!number_of_wchars)
+        {
+            return false;
+        }
+
+        const int length = static_cast<int>(std::wcslen(value)) + (suffix ? 1 : 0);
+
+        if (out)
+        {
+            for (int i = 0; i < length && i < *number_of_wchars; i++)
+            {
+                out[i] = (suffix && i == length - 1) ? suffix : value[i];
+            }
+        }
+
+        *number_of_wchars = length;
+        return true;
+    }
+
+    template<typename T>
+    bool Write(T* out, T value)
+    {
+        if (!out)
+        {
+            return false;
+        }
+
+        *out = value;
+        return true;
+    }
+
+    bool Calibration(unsigned long display_index, float* center, float* pitch, float* slope, int* width, int* height, float* dpi, float* flip_x, int* invView, float* viewcone, float* fringe, int* cell_pattern_mode, int* number_of_cells, CalibrationSubpixelCell* cells)
+    {
+        if (!IsDisplay(display_index) || !center || !pitch || !slope || !width || !height || !dpi || !flip_x ||
+            !invView || !viewcone || !fringe || !cell_pattern_mode || !number_of_cells)
+        {
+            return false;
+        }
+
+        *center = 0.0565f + 0.001f * display_index;
+        *pitch = 246.866f;
+        *slope = -6.4f;
+        *width = static_cast<int>(DisplayWidth);
+        *height = static_cast<int>(DisplayHeight);
+        *dpi = 324.0f;
+        *flip_x = 0.0f;
+        *invView = 1;
+        *viewcone = Viewcone;
+        *fringe = 0.0f;
+        *cell_pattern_mode = 0;
+
+        if (cells)
+        {
+            for (int i = 0; i < CellCount && i < *number_of_cells; i++)
+            {
+                float o = 0.001f * i;
+                cells[i] = { o, 0.0f, 0.0f, o, -o, 0.0f };
+            }
+        }
+
+        *number_of_cells = CellCount;
+        return true;
+    }
+
+    bool QuiltSettings(float* aspect, int* quilt_width, int* quilt_height, int* quilt_columns, int* quilt_rows)
+    {
+        return Write(aspect, Aspect) &&
+               Write(quilt_width, QuiltWidth) &&
+               Write(quilt_height, QuiltHeight) &&
+               Write(quilt_columns, QuiltColumns) &&
+               Write(quilt_rows, QuiltRows);
+    }
+}
+
+#ifdef _WIN32
+bool initialize_bridge(const wchar_t* app_name)
+#else
+bool initialize_bridge(const char* app_name)
+#endif
+{
+    RefreshDisplayCount();
+    return app_name != nullptr;
+}
+
+bool uninitialize_bridge()
+{
+    return true;
+}
+
+bool get_bridge_version(unsigned long* major, unsigned long* minor, unsigned long* build, int* number_of_postfix_wchars, wchar_t* postfix)
+{
+    return Write(major, 2ul) && Write(minor, 6ul) && Write(build, 2ul) &&
+           CopyString(L"loopback", 0, number_of_postfix_wchars, postfix);
+}
+
+// ---------------------------------------------------------------- windows --
+
+bool instance_window_gl(WINDOW_HANDLE* wnd, unsigned long display_index)
+{
+    if (display_index == static_cast<unsigned long>(FIRST_LOOKING_GLASS_DEVICE))
+    {
+        display_index = 0;
+    }
+
+    return IsDisplay(display_index) && Write(wnd, static_cast<WINDOW_HANDLE>(display_index + 1));
+}
+
+bool instance_offscreen_window(WINDOW_HANDLE* wnd, unsigned long width, unsigned long height, const wchar_t* calibration_path)
+{
+    return Write(wnd, static_cast<WINDOW_HANDLE>(1));
+}
+
+bool instance_offscreen_window_gl(WINDOW_HANDLE* wnd, unsigned long display_index)
+{
+    return instance_window_gl(wnd, display_index);
+}
+
+bool get_offscreen_window_texture_gl(WINDOW_HANDLE wnd, unsigned long long* texture, PixelFormats* format, unsigned long* width, unsigned long* height)
+{
+    return IsWindow(wnd) &&
+           Write(texture, 1ull) &&
+           Write(format, PixelFormats::RGBA) &&
+           Write(width, DisplayWidth) &&
+           Write(height, DisplayHeight);
+}
+
+bool quiltify_rgbd(WINDOW_HANDLE wnd, unsigned long columns, unsigned long rows, unsigned long views, float aspect, float zoom, float cam_dist, float fov, float crop_pos_x, float crop_pos_y, unsigned long depth_inversion, unsigned long chroma_depth, unsigned long depth_loc, float depthiness, float depth_cutoff, float focus, const wchar_t* input_path, const wchar_t* output_path)
+{
+    return IsWindow(wnd) && input_path && output_path;
+}
+
+bool get_window_dimensions(WINDOW_HANDLE wnd, unsigned long* width, unsigned long* height)
+{
+    return IsWindow(wnd) && Write(width, DisplayWidth) && Write(height, DisplayHeight);
+}
+
+bool get_window_position(WINDOW_HANDLE wnd, long* x, long* y)
+{
+    return IsWindow(wnd) && Write(x, static_cast<long>(DisplayWidth * wnd)) && Write(y, 0l);
+}
+
+bool get_max_texture_size(WINDOW_HANDLE wnd, unsigned long* size)
+{
+    return IsWindow(wnd) && Write(size, 16384ul);
+}
+
+bool set_interop_quilt_texture_gl(WINDOW_HANDLE wnd, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height, unsigned long vx, unsigned long vy, float aspect, float zoom)
+{
+    return IsWindow(wnd) && texture != 0;
+}
+
+bool draw_interop_quilt_texture_gl(WINDOW_HANDLE wnd, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height, unsigned long vx, unsigned long vy, float aspect, float zoom)
+{
+    return IsWindow(wnd) && texture != 0;
+}
+
+bool draw_interop_rgbd_texture_gl(WINDOW_HANDLE wnd, unsigned long texture, PixelFormats format, unsigned int width, unsigned int height, unsigned int quiltWidth, unsigned int quiltHeight, unsigned int vx, unsigned int vy, float focus, float offset, float aspect, float zoom, int depth_loc)
+{
+    return IsWindow(wnd) && texture != 0;
+}
+
+bool show_window(WINDOW_HANDLE wnd, bool flag)
+{
+    return IsWindow(wnd);
+}
+
+#ifdef WIN32
+bool save_texture_to_file_gl(WINDOW_HANDLE wnd, wchar_t* filename, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height)
+#else
+bool save_texture_to_file_gl(WINDOW_HANDLE wnd, char* filename, unsigned long long texture, PixelFormats format, unsigned long width, unsigned long height)
+#endif
+{
+    return IsWindow(wnd) && filename && texture != 0;
+}
+
+#ifdef WIN32
+bool save_image_to_file(WINDOW_HANDLE wnd, wchar_t* filename, void* image, PixelFormats format, unsigned long width, unsigned long height)
+#else
+bool save_image_to_file(WINDOW_HANDLE wnd, char* filename, void* image, PixelFormats format, unsigned long width, unsigned long height)
+#endif
+{
+    return IsWindow(wnd) && filename && image;
+}
+
+#ifdef WIN32
+bool device_from_resource_dx(IUnknown* dx_resource, IUnknown** dx_device) { return false; }
+bool release_device_dx(IUnknown* dx_device) { return false; }
+bool instance_window_dx(IUnknown* dx_device, WINDOW_HANDLE* wnd, unsigned long display_index) { return false; }
+bool instance_offscreen_window_dx(IUnknown* dx_device, WINDOW_HANDLE* wnd, unsigned long display_index) { return false; }
+bool register_texture_dx(WINDOW_HANDLE wnd, IUnknown* dx_texture) { return false; }
+bool unregister_texture_dx(WINDOW_HANDLE wnd, IUnknown* dx_texture) { return false; }
+bool save_texture_to_file_dx(WINDOW_HANDLE wnd, wchar_t* filename, IUnknown* dx_texture) { return false; }
+bool draw_interop_quilt_texture_dx(WINDOW_HANDLE wnd, IUnknown* dx_texture, unsigned long vx, unsigned long vy, float aspect, float zoom) { return false; }
+bool draw_interop_rgbd_texture_dx(WINDOW_HANDLE wnd, IUnknown* dx_texture, unsigned int width, unsigned int height, unsigned int quiltWidth, unsigned int quiltHeight, unsigned int vx, unsigned int vy, float focus, float offset, float aspect, float zoom, int depth_loc) { return false; }
+bool create_texture_dx(WINDOW_HANDLE wnd, unsigned long width, unsigned long height, IUnknown** dx_texture) { return false; }
+bool release_texture_dx(WINDOW_HANDLE wnd, IUnknown* dx_texture) { return false; }
+bool copy_texture_dx(WINDOW_HANDLE wnd, IUnknown* src, IUnknown* dest) { return false; }
+bool get_offscreen_window_texture_dx(WINDOW_HANDLE wnd, IUnknown** dx_texture) { return false; }
+#endif
+
+#ifdef __APPLE__
+bool instance_window_metal(void* metal_device, WINDOW_HANDLE* wnd, unsigned long display_index) { return false; }
+bool create_metal_texture_with_iosurface(WINDOW_HANDLE wnd, void* descriptor, void** texture) { return false; }
+bool copy_metal_texture(WINDOW_HANDLE wnd, void* src, void* dest) { return false; }
+bool release_metal_texture(WINDOW_HANDLE wnd, void* texture) { return false; }
+bool save_metal_texture_to_file(WINDOW_HANDLE wnd, char* filename, void* texture, PixelFormats format, unsigned long width, unsigned long height) { return false; }
+bool draw_interop_quilt_texture_metal(WINDOW_HANDLE wnd, void* texture, unsigned long vx, unsigned long vy, float aspect, float zoom) { return false; }
+bool instance_offscreen_window_metal(void* metal_device, WINDOW_HANDLE* wnd, unsigned long display_index) { return false; }
+bool get_offscreen_window_texture_metal(WINDOW_HANDLE wnd, void** texture) { return false; }
+#endif
+
+// --------------------------------------------------------- window queries --
+
+bool get_calibration(WINDOW_HANDLE wnd, float* center, float* pitch, float* slope, int* width, int* height, float* dpi, float* flip_x, int* invView, float* viewcone, float* fringe, int* cell_pattern_mode, int* number_of_cells, CalibrationSubpixelCell* cells)
+{
+    return IsWindow(wnd) && Calibration(wnd - 1, center, pitch, slope, width, height, dpi, flip_x, invView, viewcone, fringe, cell_pattern_mode, number_of_cells, cells);
+}
+
+bool get_device_name(WINDOW_HANDLE wnd, int* number_of_device_name_wchars, wchar_t* device_name)
+{
+    return IsWindow(wnd) && CopyString(LoopbackName, 0, number_of_device_name_wchars, device_name);
+}
+
+bool get_device_serial(WINDOW_HANDLE wnd, int* number_of_serial_wchars, wchar_t* serial)
+{
+    return IsWindow(wnd) && CopyString(LoopbackSerial, wchar_t(L'0' + (wnd - 1)), number_of_serial_wchars, serial);
+}
+
+bool get_default_quilt_settings(WINDOW_HANDLE wnd, float* aspect, int* quilt_width, int* quilt_height, int* quilt_columns, int* quilt_rows)
+{
+    return IsWindow(wnd) && QuiltSettings(aspect, quilt_width, quilt_height, quilt_columns, quilt_rows);
+}
+
+bool get_display_for_window(WINDOW_HANDLE wnd, unsigned long* display_index)
+{
+    return IsWindow(wnd) && Write(display_index, static_cast<unsigned long>(wnd - 1));
+}
+
+bool get_device_type(WINDOW_HANDLE wnd, int* hw_enum)         { return IsWindow(wnd) && Write(hw_enum, 5); }
+bool get_viewcone(WINDOW_HANDLE wnd, float* viewcone)         { return IsWindow(wnd) && Write(viewcone, Viewcone); }
+bool get_invview(WINDOW_HANDLE wnd, int* invview)             { return IsWindow(wnd) && Write(invview, 1); }
+bool get_ri(WINDOW_HANDLE wnd, int* ri)                       { return IsWindow(wnd) && Write(ri, 0); }
+bool get_bi(WINDOW_HANDLE wnd, int* bi)                       { return IsWindow(wnd) && Write(bi, 2); }
+bool get_tilt(WINDOW_HANDLE wnd, float* tilt)                 { return IsWindow(wnd) && Write(tilt, -0.1153f); }
+bool get_displayaspect(WINDOW_HANDLE wnd, float* aspect)      { return IsWindow(wnd) && Write(aspect, Aspect); }
+bool get_fringe(WINDOW_HANDLE wnd, float* fringe)             { return IsWindow(wnd) && Write(fringe, 0.0f); }
+bool get_subp(WINDOW_HANDLE wnd, float* subp)                 { return IsWindow(wnd) && Write(subp, 0.000217f); }
+bool get_pitch(WINDOW_HANDLE wnd, float* pitch)               { return IsWindow(wnd) && Write(pitch, 246.866f); }
+bool get_center(WINDOW_HANDLE wnd, float* center)             { return IsWindow(wnd) && Write(center, 0.0565f); }
+
+// -------------------------------------------------------- display queries --
+
+bool get_displays(int* number_of_indices, unsigned long* indices)
+{
+    if (!number_of_indices)
+    {
+        return false;
+    }
+
+    const int count = RefreshDisplayCount();
+
+    if (indices)
+    {
+        for (int i = 0; i < count && i < *number_of_indices; i++)
+        {
+            indices[i] = static_cast<unsigned long>(i);
+        }
+    }
+
+    *number_of_indices = count;
+    return true;
+}
+
+bool get_device_name_for_display(unsigned long display_index, int* number_of_device_name_wchars, wchar_t* device_name)
+{
+    return IsDisplay(display_index) && CopyString(LoopbackName, 0, number_of_device_name_wchars, device_name);
+}
+
+bool get_device_serial_for_display(unsigned long display_index, int* number_of_serial_wchars, wchar_t* serial)
+{
+    return IsDisplay(display_index) && CopyString(LoopbackSerial, wchar_t(L'0' + display_index), number_of_serial_wchars, serial);
+}
+
+bool get_dimensions_for_display(unsigned long display_index, unsigned long* width, unsigned long* height)
+{
+    return IsDisplay(display_index) && Write(width, DisplayWidth) && Write(height, DisplayHeight);
+}
+
+bool get_window_position_for_display(unsigned long display_index, long* x, long* y)
+{
+    return IsDisplay(display_index) && Write(x, static_cast<long>(DisplayWidth * (display_index + 1))) && Write(y, 0l);
+}
+
+bool get_calibration_for_display(unsigned long display_index, float* center, float* pitch, float* slope, int* width, int* height, float* dpi, float* flip_x, int* invView, float* viewcone, float* fringe, int* cell_pattern_mode, int* number_of_cells, CalibrationSubpixelCell* cells)
+{
+    return Calibration(display_index, center, pitch, slope, width, height, dpi, flip_x, invView, viewcone, fringe, cell_pattern_mode, number_of_cells, cells);
+}
+
+bool get_default_quilt_settings_for_display(unsigned long display_index, float* aspect, int* quilt_width, int* quilt_height, int* quilt_columns, int* quilt_rows)
+{
+    return IsDisplay(display_index) && QuiltSettings(aspect, quilt_width, quilt_height, quilt_columns, quilt_rows);
+}
+
+bool get_device_type_for_display(unsigned long display_index, int* hw_enum)         { return IsDisplay(display_index) && Write(hw_enum, 5); }
+bool get_invview_for_display(unsigned long display_index, int* invview)             { return IsDisplay(display_index) && Write(invview, 1); }
+bool get_ri_for_display(unsigned long display_index, int* ri)                       { return IsDisplay(display_index) && Write(ri, 0); }
+bool get_bi_for_display(unsigned long display_index, int* bi)                       { return IsDisplay(display_index) && Write(bi, 2); }
+bool get_tilt_for_display(unsigned long display_index, float* tilt)                 { return IsDisplay(display_index) && Write(tilt, -0.1153f); }
+bool get_displayaspect_for_display(unsigned long display_index, float* aspect)      { return IsDisplay(display_index) && Write(aspect, Aspect); }
+bool get_fringe_for_display(unsigned long display_index, float* fringe)             { return IsDisplay(display_index) && Write(fringe, 0.0f); }
+bool get_subp_for_display(unsigned long display_index, float* subp)                 { return IsDisplay(display_index) && Write(subp, 0.000217f); }
+bool get_viewcone_for_display(unsigned long display_index, float* viewcone)         { return IsDisplay(display_index) && Write(viewcone, Viewcone); }
+bool get_pitch_for_display(unsigned long display_index, float* pitch)               { return IsDisplay(display_index) && Write(pitch, 246.866f); }
+bool get_center_for_display(unsigned long display_index, float* center)             { return IsDisplay(display_index) && Write(center, 0.0565f + 0.001f * display_index); }
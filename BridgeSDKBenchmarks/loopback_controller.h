@@ -0,0 +1,35 @@
+#pragma once
+
+#include <bridge.h>
+#include <bridge_utils.hpp>
+
+#include <filesystem>
+
+// Controller that binds the loopback runtime straight from its build directory,
+// without going through settings.json.
+namespace bench
+{
+#ifdef _WIN32
+    const char RuntimeLibraryName[] = "bridge_inproc.dll";
+#elif __APPLE__
+    const char RuntimeLibraryName[] = "libbridge_inproc.dylib";
+#else
+    const char RuntimeLibraryName[] = "libbridge_inproc.so";
+#endif
+
+    class LoopbackController : public Controller
+    {
+    public:
+        bool Load(const std::filesystem::path& directory)
+        {
+            _libraryPath = (directory / RuntimeLibraryName).native();
+            if (!OpenRuntime() || !BindFunctions())
+            {
+                return false;
+            }
+
+            PublishFunctions();
+            return true;
+        }
+    };
+}
@@ -0,0 +1,121 @@
+// Per-frame overhead of walking the views of a 100-view quilt, without drawing.
+//
+// "nested loop" is what the samples used to do: an x/y loop that derives the
+// inverted row, view index and normalizedView with a division per view. "constexpr
+// table" walks QuiltLayout<10, 10>::Cells and "runtime table" a QuiltLayoutTable
+// built for the same layout at run time. All three must visit the same views.
+
+#include "benchmark.h"
+
+#include <bridge_quilt_layout.hpp>
+
+#include <cstring>
+
+namespace
+{
+    struct Viewport
+    {
+        int x, y;
+        float normalizedView;
+    };
+
+    bool SameCell(const QuiltViewCell& a, const QuiltViewCell& b)
+    {
+        return a.column == b.column && a.row == b.row &&
+               std::memcmp(&a.normalizedView, &b.normalizedView, sizeof(float)) == 0;
+    }
+
+    // Checks a QuiltLayout table against the cells QuiltLayoutTable builds at run
+    // time for the same layout.
+    template<int VX, int VY>
+    bool CheckLayout(bool expectKnown)
+    {
+        QuiltLayoutTable table(VX, VY);
+        if (table.IsKnownLayout() != expectKnown || table.Views() != VX * VY)
+        {
+            return false;
+        }
+
+        for (int y = 0; y < VY; y++)
+        {
+            for (int x = 0; x < VX; x++)
+            {
+                int viewIndex = y * VX + x;
+                QuiltViewCell expected;
+                expected.column = static_cast<unsigned short>(x);
+                expected.row = static_cast<unsigned short>(VY - 1 - y);
+                expected.normalizedView = static_cast<float>(viewIndex) / static_cast<float>(VX * VY - 1);
+                if (!SameCell(QuiltLayout<VX, VY>::Cells[viewIndex], expected) || !SameCell(table[viewIndex], expected))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    if (!CheckLayout<5, 9>(true) || !CheckLayout<8, 6>(true) || !CheckLayout<11, 6>(true) ||
+        !CheckLayout<7, 7>(true) || !CheckLayout<10, 10>(false))
+    {
+        std::printf("quilt layout tables disagree with the nested loop\n");
+        return 1;
+    }
+
+    // Read through volatile so the runtime loop cannot be specialized for 10x10.
+    volatile int vxSource = 10, vySource = 10, widthSource = 409, heightSource = 409;
+    const int vx = vxSource, vy = vySource;
+    const int viewWidth = widthSource, viewHeight = heightSource;
+    const size_t iterations = 200000;
+
+    Viewport viewport = {};
+
+    double nested = bench::NanosecondsPerOp(iterations, [&](size_t)
+    {
+        int totalViews = vx * vy;
+        for (int y = 0; y < vy; y++)
+        {
+            for (int x = 0; x < vx; x++)
+            {
+                int invertedY = vy - 1 - y;
+                int viewIndex = y * vx + x;
+                viewport.x = x * viewWidth;
+                viewport.y = invertedY * viewHeight;
+                viewport.normalizedView = static_cast<float>(viewIndex) / static_cast<float>(totalViews - 1);
+                bench::DoNotOptimize(viewport.normalizedView);
+            }
+        }
+    });
+
+    double constant = bench::NanosecondsPerOp(iterations, [&](size_t)
+    {
+        for (const QuiltViewCell& cell : QuiltLayout<10, 10>::Cells)
+        {
+            viewport.x = cell.column * viewWidth;
+            viewport.y = cell.row * viewHeight;
+            viewport.normalizedView = cell.normalizedView;
+            bench::DoNotOptimize(viewport.normalizedView);
+        }
+    });
+
+    QuiltLayoutTable table(vx, vy);
+    double runtime = bench::NanosecondsPerOp(iterations, [&](size_t)
+    {
+        for (const QuiltViewCell& cell : table)
+        {
+            viewport.x = cell.column * viewWidth;
+            viewport.y = cell.row * viewHeight;
+            viewport.normalizedView = cell.normalizedView;
+            bench::DoNotOptimize(viewport.normalizedView);
+        }
+    });
+
+    std::printf("Quilt view loop, 100 views (10x10), per frame\n");
+    bench::Report("nested loop", nested);
+    bench::Report("constexpr table", constant);
+    bench::Report("runtime table", runtime);
+
+    return 0;
+}
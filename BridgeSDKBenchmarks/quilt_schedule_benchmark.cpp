@@ -0,0 +1,181 @@
+// View-major against object-major quilt draw order, swept over object and view count.
+//
+// This illustrates the cost model; it does not measure a driver. There is no GPU
+// here, so draws go to a mock device that skips redundant binds like
+// ogl::StateCache and spends work per call it issues in proportion to the
+// QuiltDrawCosts it is given. The timings show how the call counts of each order
+// trade off under those costs, plus the real cost of the schedule loop and bind
+// checks. Which order wins on hardware depends on costs measured there, so the
+// benchmark does not judge QuiltDrawSchedule::Choose; it only checks that
+// QuiltDrawSchedule::Count matches the calls the device saw.
+//
+// "shared" scenes draw one mesh with one program and texture at different model
+// matrices; "distinct" scenes give every object its own mesh and texture and spread
+// them over four programs.
+
+#include "benchmark.h"
+
+#include <bridge_quilt_schedule.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    class MockDevice
+    {
+    public:
+        QuiltDrawCounts counts;
+
+        explicit MockDevice(const QuiltDrawCosts& costs)
+            : costs(costs)
+        {
+        }
+
+        void Draw(const QuiltDrawItem& item, int object, int view)
+        {
+            if (!bound || item.program != program)
+            {
+                program = item.program;
+                Spin(costs.programBind);
+                counts.programBinds++;
+            }
+            if (!bound || item.vertexArray != vertexArray)
+            {
+                vertexArray = item.vertexArray;
+                Spin(costs.vertexArrayBind);
+                counts.vertexArrayBinds++;
+            }
+            if (!bound || item.texture != texture)
+            {
+                texture = item.texture;
+                Spin(costs.textureBind);
+                counts.textureBinds++;
+            }
+            if (object != lastObject)
+            {
+                lastObject = object;
+                Spin(costs.objectChange);
+                counts.objectChanges++;
+            }
+            if (view != lastView)
+            {
+                lastView = view;
+                Spin(costs.viewChange);
+                counts.viewChanges++;
+            }
+            Spin(costs.draw);
+            counts.draws++;
+            bound = true;
+        }
+
+        void BeginFrame()
+        {
+            bound = false;
+            lastObject = -1;
+            lastView = -1;
+            counts = QuiltDrawCounts();
+        }
+
+        uint32_t Sink() const { return state; }
+
+    private:
+        static const int UnitIterations = 16;
+
+        QuiltDrawCosts costs;
+        bool           bound = false;
+        unsigned int   program = 0;
+        unsigned int   vertexArray = 0;
+        unsigned int   texture = 0;
+        int            lastObject = -1;
+        int            lastView = -1;
+        uint32_t       state = 1;
+
+        void Spin(double units)
+        {
+            int iterations = static_cast<int>(units * UnitIterations);
+            for (int i = 0; i < iterations; i++)
+            {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+            }
+        }
+    };
+
+    std::vector<QuiltDrawItem> MakeScene(bool shared, int objects)
+    {
+        std::vector<QuiltDrawItem> items(static_cast<size_t>(objects));
+        for (int object = 0; object < objects; object++)
+        {
+            unsigned int id = static_cast<unsigned int>(object);
+            items[object] = shared ? QuiltDrawItem{ 1, 1, 1 } : QuiltDrawItem{ 1 + id % 4, 1 + id, 1 + id };
+        }
+        return items;
+    }
+
+    bool SameCounts(const QuiltDrawCounts& a, const QuiltDrawCounts& b)
+    {
+        return a.programBinds == b.programBinds && a.vertexArrayBinds == b.vertexArrayBinds &&
+               a.textureBinds == b.textureBinds && a.objectChanges == b.objectChanges &&
+               a.viewChanges == b.viewChanges && a.draws == b.draws;
+    }
+
+    // Runs one frame in order and checks the device saw the calls Count predicts.
+    double TimeFrame(MockDevice& device, QuiltDrawOrder order, const std::vector<QuiltDrawItem>& items, int views, bool& countsMatch)
+    {
+        int objects = static_cast<int>(items.size());
+        size_t iterations = size_t(20000 / (objects * views)) + 3;
+
+        double ns = bench::NanosecondsPerOp(iterations, [&](size_t)
+        {
+            device.BeginFrame();
+            QuiltDrawSchedule::ForEach(order, objects, views, [&](int object, int view)
+            {
+                device.Draw(items[object], object, view);
+            });
+            bench::DoNotOptimize(device.Sink());
+        });
+
+        countsMatch = countsMatch && SameCounts(device.counts, QuiltDrawSchedule::Count(order, items.data(), objects, views));
+        return ns;
+    }
+}
+
+int main()
+{
+    const int objectCounts[] = { 1, 4, 16, 64 };
+    const int viewCounts[] = { 8, 45, 100 };
+
+    // Placeholder costs, the same uncalibrated values the samples start from.
+    const QuiltDrawCosts costs;
+    MockDevice device(costs);
+    bool countsMatch = true;
+
+    std::printf("Quilt draw order, us per frame on the mock device (cost model illustration)\n");
+    std::printf("  %-9s %7s %5s %12s %12s\n", "scene", "objects", "views", "view-major", "object-major");
+
+    for (bool shared : { true, false })
+    {
+        for (int objects : objectCounts)
+        {
+            std::vector<QuiltDrawItem> items = MakeScene(shared, objects);
+            for (int views : viewCounts)
+            {
+                double viewMajor = TimeFrame(device, QuiltDrawOrder::ViewMajor, items, views, countsMatch);
+                double objectMajor = TimeFrame(device, QuiltDrawOrder::ObjectMajor, items, views, countsMatch);
+
+                std::printf("  %-9s %7d %5d %12.2f %12.2f\n", shared ? "shared" : "distinct", objects, views,
+                            viewMajor / 1000.0, objectMajor / 1000.0);
+            }
+        }
+    }
+
+    if (!countsMatch)
+    {
+        std::printf("QuiltDrawSchedule::Count disagrees with the calls the mock device issued\n");
+        return 1;
+    }
+
+    return 0;
+}
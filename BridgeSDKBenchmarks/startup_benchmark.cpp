@@ -0,0 +1,217 @@
+// Cold-start cost of Controller::Initialize against the loopback runtime.
+//
+// Every sample runs in a freshly forked child that has never loaded the runtime,
+// so each one pays the full settings lookup, dlopen, symbol binding and
+// initialize_bridge cost. HOME is pointed at a scratch directory holding a
+// settings.json whose install location is the loopback build directory.
+
+#include <bridge.h>
+#include <bridge_utils.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+
+namespace
+{
+    enum Phase
+    {
+        SettingsLookup,
+        SettingsLookupCached,
+        DlopenLazy,
+        DlopenNow,
+        SymbolBinding,
+        InitializeBridge,
+        TotalInitialize,
+        PhaseCount
+    };
+
+    const char* PhaseNames[PhaseCount] =
+    {
+        "settings lookup",
+        "settings lookup (cached)",
+        "dlopen (RTLD_LAZY)",
+        "dlopen (RTLD_NOW)",
+        "symbol binding",
+        "initialize_bridge",
+        "Controller::Initialize (end to end)",
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    double Microseconds(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    // Exposes the individual Initialize steps so they can be timed separately.
+    class StartupController : public Controller
+    {
+    public:
+        void SetLibrary(const std::string& path) { _libraryPath = path; }
+        bool Open()                               { return OpenRuntime(); }
+        bool Bind()                               { return BindFunctions(); }
+        bool CallInitialize(const char* app_name) { return _bridge.initialize_bridge && _bridge.initialize_bridge(app_name); }
+    };
+
+    // Settings lookup, dlopen, binding and initialize_bridge as separate steps.
+    void MeasurePhases(double* out, bool bindNow)
+    {
+        StartupController controller;
+        controller.SetBindNow(bindNow);
+
+        auto t0 = Clock::now();
+        std::string installPath = controller.BridgeInstallLocation(::BridgeVersion);
+        auto t1 = Clock::now();
+
+        // a second lookup, as SwitchBridgeVersion or another Controller would do
+        controller.BridgeInstallLocation(::BridgeVersion);
+        auto tc = Clock::now();
+
+        controller.SetLibrary((std::filesystem::path(installPath) / "libbridge_inproc.so").string());
+        auto to = Clock::now();
+        bool opened = controller.Open();
+        auto t2 = Clock::now();
+
+        bool bound = opened && controller.Bind();
+        auto t3 = Clock::now();
+
+        bool initialized = bound && controller.CallInitialize("startup_benchmark");
+        auto t4 = Clock::now();
+
+        out[SettingsLookup]                   = Microseconds(t0, t1);
+        out[SettingsLookupCached]             = Microseconds(t1, tc);
+        out[bindNow ? DlopenNow : DlopenLazy] = opened ? Microseconds(to, t2) : -1.0;
+        out[SymbolBinding]                    = Microseconds(t2, t3);
+        out[InitializeBridge]                 = initialized ? Microseconds(t3, t4) : -1.0;
+    }
+
+    void MeasureTotal(double* out)
+    {
+        Controller controller;
+
+        std::streambuf* previous = std::cout.rdbuf(nullptr);
+        auto t0 = Clock::now();
+        bool initialized = controller.Initialize("startup_benchmark");
+        auto t1 = Clock::now();
+        std::cout.rdbuf(previous);
+
+        out[TotalInitialize] = initialized ? Microseconds(t0, t1) : -1.0;
+    }
+
+    // Runs measure in a freshly forked child and merges the timings it reports.
+    template<typename Measure>
+    bool RunCold(double* timings, Measure measure)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            return false;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(fds[0]);
+            double out[PhaseCount];
+            std::fill(out, out + PhaseCount, 0.0);
+            measure(out);
+            _exit(write(fds[1], out, sizeof(out)) == sizeof(out) ? 0 : 1);
+        }
+
+        close(fds[1]);
+        double out[PhaseCount];
+        bool ok = read(fds[0], out, sizeof(out)) == sizeof(out);
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+
+        for (int p = 0; ok && p < PhaseCount; p++)
+        {
+            if (out[p] < 0.0)
+            {
+                ok = false;
+            }
+            else if (out[p] > 0.0)
+            {
+                timings[p] = out[p];
+            }
+        }
+
+        return ok;
+    }
+
+    bool Sample(double* timings)
+    {
+        return RunCold(timings, [](double* out) { MeasurePhases(out, true); }) &&
+               RunCold(timings, [](double* out) { MeasurePhases(out, false); }) &&
+               RunCold(timings, [](double* out) { MeasureTotal(out); });
+    }
+
+    bool WriteSettings(const std::filesystem::path& home, const std::filesystem::path& runtimeDir)
+    {
+        std::filesystem::path bridgeDir = home / ".lgf" / "Bridge";
+        std::filesystem::create_directories(bridgeDir);
+
+        std::ofstream out(bridgeDir / "settings.json");
+        out << "{\n"
+            << "    \"install_locations\": [\n"
+            << "        { \"path\": \"/opt/lookingglass/bridge-2.5.0\", \"version\": \"2.5.0\" },\n"
+            << "        { \"path\": \"" << runtimeDir.string() << "\", \"version\": \"" << ::BridgeVersion << "\" }\n"
+            << "    ],\n"
+            << "    \"enable_utilization_telemetry\": true\n"
+            << "}\n";
+        return bool(out);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path runtimeDir = std::filesystem::absolute(argc > 1 ? argv[1] : LOOPBACK_RUNTIME_DIR);
+    int samples = argc > 2 ? std::max(1, std::atoi(argv[2])) : 25;
+
+    char scratch[] = "/tmp/bridge-startup-XXXXXX";
+    if (!mkdtemp(scratch) || !WriteSettings(scratch, runtimeDir))
+    {
+        std::printf("failed to create scratch settings\n");
+        return 1;
+    }
+
+    setenv("HOME", scratch, 1);
+
+    std::vector<double> timings[PhaseCount];
+    for (int i = 0; i < samples; i++)
+    {
+        double sample[PhaseCount] = {};
+        if (!Sample(sample))
+        {
+            std::printf("cold start failed, is %s a loopback build directory?\n", runtimeDir.string().c_str());
+            std::filesystem::remove_all(scratch);
+            return 1;
+        }
+
+        for (int p = 0; p < PhaseCount; p++)
+        {
+            timings[p].push_back(sample[p]);
+        }
+    }
+
+    std::filesystem::remove_all(scratch);
+
+    std::printf("Controller cold start, %d samples (%s)\n", samples, runtimeDir.string().c_str());
+    std::printf("  %-40s %10s %10s %10s\n", "phase", "min us", "median us", "max us");
+
+    for (int p = 0; p < PhaseCount; p++)
+    {
+        std::vector<double>& t = timings[p];
+        std::sort(t.begin(), t.end());
+        std::printf("  %-40s %10.1f %10.1f %10.1f\n", PhaseNames[p], t.front(), t[t.size() / 2], t.back());
+    }
+
+    return 0;
+}
@@ -6,6 +6,8 @@
 #include <bridge.h>
 #include <bridge_utils.hpp>
 #include <LKGCamera.hpp>
+#include <bridge_quilt_layout.hpp>
+#include <bridge_quilt_schedule.hpp>
 #include <memory>
 #include <codecvt>
 #include <locale>
@@ -16,6 +18,8 @@
 #include <ogl.h>
 #include <chrono>
 #include <numeric>
+#include <deque>
+#include <future>
 
 
 #ifdef _WIN32
@@ -39,6 +43,37 @@ const char* vertexShaderSource =
     "    vertexColor = color;\n"
     "}\n";
 
+// The quilt pass reads every view's matrices from one uniform buffer, see
+// ogl::QuiltViewBuffer. With quiltSize set, instance i draws view firstView + i and
+// is moved from a full-viewport projection into its quilt cell, clipped to the cell
+// by gl_ClipDistance; with quiltSize (0, 0) it draws viewIndex into the bound viewport.
+const char* quiltVertexShaderSource =
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 position;\n"
+    "layout (location = 1) in vec3 color;\n"
+    "out vec3 vertexColor;\n"
+    "struct QuiltView { mat4 view; mat4 projection; };\n"
+    "layout (std140) uniform QuiltViews { QuiltView views[128]; };\n"
+    "uniform mat4 model;\n"
+    "uniform int viewIndex;\n"
+    "uniform int firstView;\n"
+    "uniform ivec2 quiltSize;\n"
+    "void main() {\n"
+    "    int view = viewIndex + gl_InstanceID;\n"
+    "    vec4 clip = views[view].projection * views[view].view * model * vec4(position, 1.0);\n"
+    "    gl_ClipDistance[0] = clip.w + clip.x;\n"
+    "    gl_ClipDistance[1] = clip.w - clip.x;\n"
+    "    gl_ClipDistance[2] = clip.w + clip.y;\n"
+    "    gl_ClipDistance[3] = clip.w - clip.y;\n"
+    "    if (quiltSize.x > 0) {\n"
+    "        int cell = firstView + gl_InstanceID;\n"
+    "        vec2 cellPosition = vec2(cell % quiltSize.x, quiltSize.y - 1 - cell / quiltSize.x);\n"
+    "        clip.xy = (clip.xy + clip.w * (2.0 * cellPosition + 1.0)) / vec2(quiltSize) - clip.w;\n"
+    "    }\n"
+    "    gl_Position = clip;\n"
+    "    vertexColor = color;\n"
+    "}\n";
+
 const char* fragmentShaderSource = 
     "#version 330 core\n"
     "in vec3 vertexColor;\n"
@@ -96,14 +131,119 @@ bool mousePressed = false;
 double lastX = 0.0, lastY = 0.0;
 float angleX = 0.0f, angleY = 0.0f;
 
+// Depth buffer of the quilt render target; depth_benchmark shows what each choice
+// costs. GL_DEPTH_COMPONENT24 resolves this scene as finely as GL_DEPTH_COMPONENT32
+// did, GL_DEPTH_COMPONENT16 halves the memory at much coarser depth, and
+// GL_DEPTH_COMPONENT32F switches the camera to reversed Z when glClipControl is
+// available, for the finest depth at the same size.
+const GLenum quiltDepthFormat = GL_DEPTH_COMPONENT24;
+
+// Quilt render targets used in turn, 1 to 3. With more than one the next quilt is
+// rendered while Bridge still reads the last, at the cost of another color buffer.
+const int quiltTargetCount = 3;
+
+// How the quilt pass submits its views. Instanced draws up to 128 views with one
+// glDrawElementsInstanced call, PerView is one glViewport and draw per view. PerView
+// is also used when instanced drawing is unavailable. The window title shows the
+// quilt pass's draw calls and CPU submission time for comparing the two.
+enum class QuiltRenderMode
+{
+    PerView,
+    Instanced
+};
+
+const QuiltRenderMode quiltRenderMode = QuiltRenderMode::Instanced;
+
+// What each GL call of the PerView quilt pass costs on this driver, relative to a
+// draw; QuiltDrawSchedule::Choose picks the draw order from them. These are
+// uncalibrated starting values. The window title shows the chosen order and its
+// submit time; adjust the costs to flip the order and keep whichever is faster.
+const QuiltDrawCosts quiltDrawCosts = { 4.0, 2.0, 2.0, 1.0, 1.5, 1.0 };
+
+// Everything the window and the quilt depend on. While it stays the same the render
+// loop neither redraws nor resubmits the quilt and sleeps until input arrives, so a
+// display showing static content costs next to no GPU time.
+struct FrameState
+{
+    uint64_t cameraVersion;
+    float    angleX;
+    float    angleY;
+    float    focus;
+    float    offsetMult;
+    int      framebufferWidth;
+    int      framebufferHeight;
+
+    bool operator==(const FrameState& other) const
+    {
+        return cameraVersion == other.cameraVersion &&
+               angleX == other.angleX && angleY == other.angleY &&
+               focus == other.focus && offsetMult == other.offsetMult &&
+               framebufferWidth == other.framebufferWidth && framebufferHeight == other.framebufferHeight;
+    }
+};
+
+// An idle loop wakes every idleWaitSeconds to check for changes, and hands the
+// unchanged quilt to Bridge again every idleResubmitSeconds. Set idleResubmitSeconds
+// to 0 to stop submitting while idle if the runtime keeps showing the last quilt.
+const double idleWaitSeconds = 0.25;
+const double idleResubmitSeconds = 1.0;
+
+// Set when the window system needs the window redrawn, e.g. after it was uncovered.
+bool frameRefreshRequested = true;
+
+// Press C to start or stop saving every rendered quilt as capture_NNNNNN.png, or
+// capture_D_NNNNNN.png for display D when there are several. Frames
+// are read back through ogl::CaptureRing and encoded on the Controller's task pool,
+// so recording does not stall the render loop; frames it cannot keep up with are
+// dropped and counted instead.
+bool captureEnabled = false;
+const int captureSlots = 3;
+
 float focus = -0.5f;
 float offset_mult = 1.0f;
 
-void drawScene(GLuint shaderProgram, GLuint vao, LKGCamera& camera, float normalizedView = 0.5f, bool invert = false, float offset_mult = 0.0f, float focus = 0.0f)
+// Landscape displays need a focus around -0.5f, widescreen displays around -2f.
+float defaultFocus(const BridgeWindowData& bridgeData)
 {
-    ogl::glBindVertexArray(vao);
-    ogl::glUseProgram(shaderProgram);
+    return bridgeData.displayaspect > 1.0 ? -0.5f : -2.0f;
+}
+
+// One looking glass display the sample renders to. Each display has its own Bridge
+// window, camera, quilt layout and render targets, set up from its own calibration
+// and default quilt settings. The geometry and programs are shared: Bridge draws
+// every GL window from the sample's one context, so there is nothing to duplicate.
+struct DisplayOutput
+{
+    BridgeWindowData         bridgeData;
+    std::string              name;
+    LKGCamera                camera;
+    float                    focusOffset = 0.0f; // from the first display's default focus
+    QuiltLayoutTable         quiltLayout;
+    QuiltDrawOrder           quiltDrawOrder = QuiltDrawOrder::ViewMajor;
+    LKGCamera::QuiltMatrices quiltMatrices;
+    ogl::QuiltViewBuffer     quiltViews;
+    ogl::QuiltTargetRing     quiltTargets;
+    ogl::CaptureRing         captureRing;
+    int                      quiltDraws = 0;
+    float                    quiltSubmitMicroseconds = 0.0f;
+};
 
+void drawScene(GLuint shaderProgram, GLuint vao, const Matrix4& modelMatrix, const Matrix4& viewMatrix, const Matrix4& projectionMatrix)
+{
+    ogl::state.bindVertexArray(vao);
+    ogl::state.useProgram(shaderProgram);
+
+    // Set uniforms
+    ogl::glUniformMatrix4fv(ogl::state.uniformLocation(shaderProgram, "model"), 1, GL_FALSE, modelMatrix.m);
+    ogl::glUniformMatrix4fv(ogl::state.uniformLocation(shaderProgram, "view"), 1, GL_FALSE, viewMatrix.m);
+    ogl::glUniformMatrix4fv(ogl::state.uniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projectionMatrix.m);
+
+    // Draw the object
+    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+}
+
+void drawScene(GLuint shaderProgram, GLuint vao, LKGCamera& camera, float normalizedView = 0.5f, bool invert = false, float offset_mult = 0.0f, float focus = 0.0f)
+{
     // Compute view and projection matrices using LKGCamera
     Matrix4 viewMatrix;
     Matrix4 projectionMatrix;
@@ -112,13 +252,7 @@ void drawScene(GLuint shaderProgram, GLuint vao, LKGCamera& camera, float normal
     // Compute the model matrix (e.g., rotating cube)
     Matrix4 modelMatrix = camera.getModelMatrix(angleX, angleY);
 
-    // Set uniforms
-    ogl::glUniformMatrix4fv(ogl::glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, modelMatrix.m);
-    ogl::glUniformMatrix4fv(ogl::glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, viewMatrix.m);
-    ogl::glUniformMatrix4fv(ogl::glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projectionMatrix.m);
-
-    // Draw the object
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+    drawScene(shaderProgram, vao, modelMatrix, viewMatrix, projectionMatrix);
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) 
@@ -158,6 +292,21 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     offset_mult += static_cast<float>(xoffset) * 0.075f; // Sensitivity
 }
 
+// Key callback function
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_C && action == GLFW_PRESS)
+    {
+        captureEnabled = !captureEnabled;
+    }
+}
+
+// Window refresh callback function
+void window_refresh_callback(GLFWwindow* window)
+{
+    frameRefreshRequested = true;
+}
+
 int main(void)
 {
     GLFWwindow* window;
@@ -194,8 +343,8 @@ int main(void)
         std::wcout << "Failed to initialize bridge. Bridge may be missing, or the version may be too old" << std::endl;
     }
 
-    WINDOW_HANDLE wnd = 0;
     std::vector<DisplayInfo> displays;
+    std::vector<DisplayOutput> outputs;
 
     if (controller)
     {
@@ -208,53 +357,58 @@ int main(void)
             std::wcout << displayInfo.name << std::endl;
         }
 
-        // For now we will use the first looking glass display
-        if (!displays.empty() && controller->InstanceWindowGL(&wnd, displays[0].display_id))
+        // Give every looking glass display its own window
+        outputs.reserve(displays.size());
+        for (const auto& displayInfo : displays)
         {
-            // Successfully created the window handle
+            WINDOW_HANDLE wnd = 0;
+            if (!controller->InstanceWindowGL(&wnd, displayInfo.display_id))
+            {
+                std::wcout << "Failed to initialize bridge window for " << displayInfo.name << std::endl;
+                continue;
+            }
+
+            BridgeWindowData bridgeData = controller->GetWindowData(wnd);
+            if (bridgeData.wnd == 0)
+            {
+                continue;
+            }
+
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            outputs.emplace_back();
+            outputs.back().bridgeData = bridgeData;
+            outputs.back().name = converter.to_bytes(displayInfo.name) + " : " + converter.to_bytes(displayInfo.serial);
         }
-        else
+
+        if (outputs.empty())
         {
-            wnd = 0;
             std::wcout << "Failed to initialize bridge window. do you have any displays connected?" << std::endl;
         }
     }
-    
-    BridgeWindowData bridgeData = controller ? controller->GetWindowData(wnd) : BridgeWindowData();
-    bool isBridgeDataInitialized = (bridgeData.wnd != 0);
+
+    bool isBridgeDataInitialized = !outputs.empty();
     std::string window_title = "";
 
     // Update window size and title if BridgeData is initialized
     if (isBridgeDataInitialized)
     {
-        // Set focus based on aspect ratio
-        // Landscape displays need around -0.5f
-        // Widescreen displays need around -2f
-        focus = bridgeData.displayaspect > 1.0 ? -0.5f : -2.0f;
+        const BridgeWindowData& bridgeData = outputs[0].bridgeData;
+
+        // Set focus based on aspect ratio, see defaultFocus. The scroll wheel moves
+        // every display's focus by the same amount.
+        focus = defaultFocus(bridgeData);
 
         // multiplies the depthiness of the 3D output
         // with a value of 1.0 objects should appear physically accurate 
         // when on the focal plane
         offset_mult = 1.0f;
 
-        // Find display info for the window title based on display index
-        auto displayInfoIt = std::find_if(
-            displays.begin(),
-            displays.end(),
-            [&bridgeData](const DisplayInfo& info)
-            {
-                return info.display_id == bridgeData.display_index;
-            }
-        );
-
-        if (displayInfoIt != displays.end())
+        window_title = "Bridge SDK Native Sample -- " + outputs[0].name;
+        if (outputs.size() > 1)
         {
-            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-            window_title = "Bridge SDK Native Sample -- " +
-                converter.to_bytes(displayInfoIt->name) +
-                " : " + converter.to_bytes(displayInfoIt->serial);
-            glfwSetWindowTitle(window, window_title.c_str());
+            window_title += " (+" + std::to_string(outputs.size() - 1) + " more)";
         }
+        glfwSetWindowTitle(window, window_title.c_str());
 
         // set 2d window to be half the size of the looking glass display we are outputting to 
         int window_width  = (int)bridgeData.output_width / 2;
@@ -266,61 +420,28 @@ int main(void)
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_position_callback);
     glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
 
     float size = 10.0f;
     Vector3 target = Vector3(0.0f, 0.0f, 0.0f);
     Vector3 up = Vector3(0.0f, 1.0f, 0.0f);
 
     float fov = 14.0f;
-    float viewcone = isBridgeDataInitialized ? bridgeData.viewcone : 40.0f;
-    float aspect = isBridgeDataInitialized ? bridgeData.displayaspect : 1.0f;
+    float viewcone = isBridgeDataInitialized ? outputs[0].bridgeData.viewcone : 40.0f;
+    float aspect = isBridgeDataInitialized ? outputs[0].bridgeData.displayaspect : 1.0f;
     float nearPlane = 0.1f;
     float farPlane = 100.0f;
 
+    // The 2D window shows the first display's view
     LKGCamera camera = LKGCamera(size, target, up, fov, viewcone, aspect, nearPlane, farPlane);
 
-    // Initialize OpenGL textures and framebuffers
-    GLuint render_texture = 0;
-    GLuint render_fbo = 0;
-    GLuint depth_buffer = 0;
-
-    if (isBridgeDataInitialized)
-    {
-        // Initialize OpenGL textures and framebuffers using bridgeData's quilt dimensions
-        glGenTextures(1, &render_texture);
-        glBindTexture(GL_TEXTURE_2D, render_texture);
-        ogl::glTexImage2D(GL_TEXTURE_2D, 
-                        0, 
-                        GL_RGBA, 
-                        bridgeData.quilt_width, 
-                        bridgeData.quilt_height, 
-                        0, 
-                        GL_RGBA,
-                        GL_UNSIGNED_BYTE, 
-                        nullptr); 
-
-        // Generate and bind the renderbuffer for depth
-        ogl::glGenRenderbuffers(1, &depth_buffer);
-        ogl::glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer); 
-
-        // Create a depth buffer
-        ogl::glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, bridgeData.quilt_width, bridgeData.quilt_height);
-
-        // Generate the framebuffer
-        ogl::glGenFramebuffers(1, &render_fbo);
-        ogl::glBindFramebuffer(GL_FRAMEBUFFER, render_fbo);
-
-        // Attach the texture to the framebuffer as a color attachment
-        ogl::glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, render_texture, 0);
-
-        // Attach the renderbuffer as a depth attachment
-        ogl::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
-
-        ogl::glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ogl::glBindRenderbuffer(GL_RENDERBUFFER, 0);
-    }
-
     GLuint shaderProgram = ogl::createProgram(vertexShaderSource, fragmentShaderSource);
+    GLuint quiltShaderProgram = ogl::createProgram(quiltVertexShaderSource, fragmentShaderSource);
+    GLint quiltModelLocation = ogl::state.uniformLocation(quiltShaderProgram, "model");
+    GLint quiltViewIndexLocation = ogl::state.uniformLocation(quiltShaderProgram, "viewIndex");
+    GLint quiltFirstViewLocation = ogl::state.uniformLocation(quiltShaderProgram, "firstView");
+    GLint quiltSizeLocation = ogl::state.uniformLocation(quiltShaderProgram, "quiltSize");
 
     GLuint vao, vbo, ebo;
     ogl::glGenVertexArrays(1, &vao);
@@ -346,22 +467,208 @@ int main(void)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    glClearDepth(1.0f);
+    // Reversed Z clears to the far value 0 and keeps the larger depth.
+    bool reversedZ = quiltDepthFormat == GL_DEPTH_COMPONENT32F && ogl::glClipControl != nullptr;
+    if (reversedZ)
+    {
+        ogl::glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        camera.setDepthMode(LKGCamera::DepthMode::ReversedZ);
+    }
+
+    glClearDepth(reversedZ ? 0.0f : 1.0f);
     glDepthRange(0.0f, 1.0f);
-    glDepthFunc(GL_LEQUAL);
+    glDepthFunc(reversedZ ? GL_GEQUAL : GL_LEQUAL);
     glEnable(GL_DEPTH_TEST);
     glPolygonMode(GL_FRONT, GL_FILL);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
-    int totalViews = bridgeData.vx * bridgeData.vy;
+    bool quiltInstanced = quiltRenderMode == QuiltRenderMode::Instanced && ogl::glDrawElementsInstanced != nullptr;
+
+    // Meshes and materials of the quilt pass, shared by every display. The per-view
+    // path visits them in the order QuiltDrawSchedule finds cheaper for the display's
+    // view count; the instanced path is always object-major.
+    const QuiltDrawItem quiltObjects[] = { { quiltShaderProgram, vao, 0 } };
+    const int quiltObjectCount = static_cast<int>(sizeof(quiltObjects) / sizeof(quiltObjects[0]));
+
+    // Each display renders with its own view cone, aspect and quilt settings
+    for (DisplayOutput& output : outputs)
+    {
+        const BridgeWindowData& bridgeData = output.bridgeData;
+        output.camera = LKGCamera(size, target, up, fov, bridgeData.viewcone, bridgeData.displayaspect, nearPlane, farPlane);
+        if (reversedZ)
+        {
+            output.camera.setDepthMode(LKGCamera::DepthMode::ReversedZ);
+        }
+        output.focusOffset = defaultFocus(bridgeData) - focus;
+        output.quiltLayout.Reset(bridgeData.vx, bridgeData.vy);
+        output.quiltDrawOrder = QuiltDrawSchedule::Choose(quiltObjects, quiltObjectCount, output.quiltLayout.Views(), quiltDrawCosts);
+        output.quiltViews.create(quiltShaderProgram, 0);
+        output.quiltTargets.create(quiltTargetCount, bridgeData.quilt_width, bridgeData.quilt_height, quiltDepthFormat);
+        output.captureRing.create(captureSlots);
+    }
+
+    // Setup above binds GL objects directly, so start the cache from scratch.
+    ogl::state.invalidate();
+
+    unsigned long long captureFrame = 0;
+    unsigned long long captureEncodeFailures = 0;
+    std::deque<std::future<bool>> captureEncodes;
+
+    // Files are capture_NNNNNN.png, or capture_D_NNNNNN.png for display D of several.
+    auto encodeCapture = [&](size_t outputIndex, unsigned long long frame, std::vector<unsigned char> pixels, GLsizei width, GLsizei height)
+    {
+        char name[48];
+        if (outputs.size() > 1)
+        {
+            snprintf(name, sizeof(name), "capture_%u_%06llu.png", unsigned(outputIndex), frame);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "capture_%06llu.png", frame);
+        }
+#ifdef _WIN32
+        std::wstring filename(name, name + strlen(name));
+#else
+        std::string filename(name);
+#endif
+        captureEncodes.push_back(controller->SaveImageToFileAsync(outputs[outputIndex].bridgeData.wnd, filename, std::move(pixels), PixelFormats::RGBA, width, height));
+    };
+
+    auto collectCaptures = [&](size_t outputIndex, bool wait)
+    {
+        outputs[outputIndex].captureRing.collect([&](unsigned long long frame, std::vector<unsigned char> pixels, GLsizei width, GLsizei height)
+        {
+            encodeCapture(outputIndex, frame, std::move(pixels), width, height);
+        }, wait);
+    };
+
+    // Drops finished encodes; one the full task queue rejected loses its frame.
+    auto reapCaptureEncodes = [&](bool wait)
+    {
+        while (!captureEncodes.empty() &&
+               (wait || captureEncodes.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready))
+        {
+            try
+            {
+                captureEncodeFailures += captureEncodes.front().get() ? 0 : 1;
+            }
+            catch (const std::exception&)
+            {
+                captureEncodeFailures++;
+            }
+            captureEncodes.pop_front();
+        }
+    };
+
+    // Draws one display's quilt into its next render target
+    auto renderQuilt = [&](DisplayOutput& output, const Matrix4& modelMatrix)
+    {
+        const BridgeWindowData& bridgeData = output.bridgeData;
+
+        // Draw the quilt views for the hologram
+        ogl::state.bindFramebuffer(output.quiltTargets.acquire().framebuffer);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // All views share one model matrix and only differ in their view offset and
+        // frustum shift, so compute every view's matrices once per frame.
+        output.camera.computeQuiltMatrices(bridgeData.vx, bridgeData.vy, true, offset_mult, focus + output.focusOffset, output.quiltMatrices);
+        auto submitStart = std::chrono::high_resolution_clock::now();
+        output.quiltViews.upload(output.quiltMatrices);
+
+        ogl::state.useProgram(quiltShaderProgram);
+        output.quiltDraws = 0;
+
+        if (quiltInstanced)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                glEnable(GL_CLIP_DISTANCE0 + i);
+            }
+
+            int views = output.quiltLayout.Views();
+            ogl::state.viewport(0, 0, bridgeData.vx * bridgeData.view_width, bridgeData.vy * bridgeData.view_height);
+            ogl::glUniform2i(quiltSizeLocation, bridgeData.vx, bridgeData.vy);
+            for (const QuiltDrawItem& object : quiltObjects)
+            {
+                ogl::state.useProgram(object.program);
+                ogl::state.bindVertexArray(object.vertexArray);
+                ogl::state.bindTexture2D(0, object.texture);
+                ogl::glUniformMatrix4fv(quiltModelLocation, 1, GL_FALSE, modelMatrix.m);
+
+                for (int firstView = 0; firstView < views; firstView += ogl::QuiltViewBuffer::BlockViews)
+                {
+                    int instances = views - firstView < ogl::QuiltViewBuffer::BlockViews ? views - firstView : ogl::QuiltViewBuffer::BlockViews;
+                    ogl::glUniform1i(quiltViewIndexLocation, output.quiltViews.bindView(firstView));
+                    ogl::glUniform1i(quiltFirstViewLocation, firstView);
+                    ogl::glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr, instances);
+                    output.quiltDraws++;
+                }
+            }
+
+            for (int i = 0; i < 4; i++)
+            {
+                glDisable(GL_CLIP_DISTANCE0 + i);
+            }
+        }
+        else
+        {
+            ogl::glUniform2i(quiltSizeLocation, 0, 0);
+            int lastObject = -1;
+            QuiltDrawSchedule::ForEach(output.quiltDrawOrder, quiltObjectCount, output.quiltLayout.Views(), [&](int object, int viewIndex)
+            {
+                const QuiltDrawItem& item = quiltObjects[object];
+                ogl::state.useProgram(item.program);
+                ogl::state.bindVertexArray(item.vertexArray);
+                ogl::state.bindTexture2D(0, item.texture);
+                if (object != lastObject)
+                {
+                    ogl::glUniformMatrix4fv(quiltModelLocation, 1, GL_FALSE, modelMatrix.m);
+                    lastObject = object;
+                }
+
+                const QuiltViewCell& cell = output.quiltLayout[viewIndex];
+                ogl::state.viewport(cell.column * bridgeData.view_width, cell.row * bridgeData.view_height, bridgeData.view_width, bridgeData.view_height);
+                ogl::glUniform1i(quiltViewIndexLocation, output.quiltViews.bindView(viewIndex));
+                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+                output.quiltDraws++;
+            });
+        }
+
+        output.quiltViews.endFrame();
+        float submitMicroseconds = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - submitStart).count();
+        output.quiltSubmitMicroseconds = output.quiltSubmitMicroseconds > 0.0f ? 0.95f * output.quiltSubmitMicroseconds + 0.05f * submitMicroseconds : submitMicroseconds;
+    };
 
     std::vector<float> frameTimes;
     const int maxSamples = 100; // Number of samples to calculate the average
     auto lastTime = std::chrono::high_resolution_clock::now();
+    FrameState lastFrameState = {};
+    auto lastSubmitTime = lastTime;
 
     // Rendering loop
     while (!glfwWindowShouldClose(window))
     {
+        int fbWidth = 0, fbHeight = 0;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+        // Skip frames whose output would not change.
+        FrameState frameState = { camera.getVersion(), angleX, angleY, focus, offset_mult, fbWidth, fbHeight };
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        bool frameChanged = frameRefreshRequested || !(frameState == lastFrameState);
+        // Only a Bridge output has anything to resubmit; without one an idle loop sleeps.
+        bool resubmit = isBridgeDataInitialized && idleResubmitSeconds > 0.0 &&
+                        std::chrono::duration<double>(frameStart - lastSubmitTime).count() >= idleResubmitSeconds;
+        if (!frameChanged && !resubmit)
+        {
+            glfwWaitEventsTimeout(idleWaitSeconds);
+            lastTime = std::chrono::high_resolution_clock::now();
+            continue;
+        }
+
+        lastFrameState = frameState;
+        frameRefreshRequested = false;
+
         auto currentTime = std::chrono::high_resolution_clock::now();
         float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - lastTime).count();
         lastTime = currentTime;
@@ -378,41 +685,56 @@ int main(void)
         }
 
         // Draw to primary head
-        ogl::glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        int fbWidth = 0, fbHeight = 0;
-        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);  
-        glViewport(0, 0, fbWidth, fbHeight);
-
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        drawScene(shaderProgram, vao, camera);
-        
-        glfwSwapBuffers(window);
-
-        if (isBridgeDataInitialized)
+        if (frameChanged)
         {
-            // Draw the quilt views for the hologram
-            ogl::glBindFramebuffer(GL_FRAMEBUFFER, render_fbo);
+            ogl::state.bindFramebuffer(0);
+            ogl::state.viewport(0, 0, fbWidth, fbHeight);
 
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            for (int y = 0; y < bridgeData.vy; y++)
-            {
-                for (int x = 0; x < bridgeData.vx; x++)
-                {
-                    int invertedY = bridgeData.vy - 1 - y;
-                    glViewport(x * bridgeData.view_width, invertedY * bridgeData.view_height, bridgeData.view_width, bridgeData.view_height);
+            drawScene(shaderProgram, vao, camera);
 
-                    int viewIndex = y * bridgeData.vx + x;
-                    float normalizedView = static_cast<float>(viewIndex) / static_cast<float>(totalViews - 1);
+            glfwSwapBuffers(window);
+        }
 
-                    drawScene(shaderProgram, vao, camera, normalizedView, true, offset_mult, focus);
-                }
+        // Every display's quilt is queued before any is handed to Bridge, so the GPU
+        // works through all of them while the interop draws are submitted, and the
+        // target rings keep a display from waiting on its own previous frame. An
+        // unchanged frame resubmits the quilt textures as they are.
+        if (isBridgeDataInitialized && frameChanged)
+        {
+            Matrix4 modelMatrix = camera.getModelMatrix(angleX, angleY);
+            for (DisplayOutput& output : outputs)
+            {
+                renderQuilt(output, modelMatrix);
             }
+        }
 
-            controller->DrawInteropQuiltTextureGL(bridgeData.wnd, render_texture, PixelFormats::RGBA,
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            DisplayOutput& output = outputs[i];
+            const BridgeWindowData& bridgeData = output.bridgeData;
+            controller->DrawInteropQuiltTextureGL(bridgeData.wnd, output.quiltTargets.current().texture, PixelFormats::RGBA,
                                                 bridgeData.quilt_width, bridgeData.quilt_height,
                                                 bridgeData.vx, bridgeData.vy, bridgeData.displayaspect, 1.0f);
+
+            if (captureEnabled && frameChanged)
+            {
+                output.captureRing.capture(output.quiltTargets.current().texture, bridgeData.quilt_width, bridgeData.quilt_height, captureFrame);
+            }
+            collectCaptures(i, false);
+
+            output.quiltTargets.release();
+        }
+
+        if (isBridgeDataInitialized)
+        {
+            captureFrame += captureEnabled && frameChanged ? 1 : 0;
+            reapCaptureEncodes(false);
+            lastSubmitTime = frameStart;
+
+            // Bridge draws with its own GL state.
+            ogl::state.invalidate();
         }
 
         glfwPollEvents();
@@ -423,8 +745,47 @@ int main(void)
         ss << " ";
         ss << averageFPS;
 
+        int quiltDraws = 0;
+        float quiltSubmitMicroseconds = 0.0f;
+        size_t quiltWaits = 0;
+        size_t quiltAcquires = 0;
+        unsigned long long captureDelivered = 0;
+        unsigned long long captureDropped = captureEncodeFailures;
+        for (const DisplayOutput& output : outputs)
+        {
+            quiltDraws += output.quiltDraws;
+            quiltSubmitMicroseconds += output.quiltSubmitMicroseconds;
+            quiltWaits += output.quiltTargets.waits();
+            quiltAcquires += output.quiltTargets.acquires();
+            captureDelivered += output.captureRing.delivered();
+            captureDropped += output.captureRing.dropped();
+        }
+
+        if (quiltDraws > 0)
+        {
+            ss << " | quilt: " << quiltDraws << (quiltInstanced ? " instanced" : outputs[0].quiltDrawOrder == QuiltDrawOrder::ObjectMajor ? " object-major" : " view-major") << " draws, " << quiltSubmitMicroseconds << " us";
+            if (outputs.size() > 1)
+            {
+                ss << " for " << outputs.size() << " displays";
+            }
+            ss << ", waited " << quiltWaits << "/" << quiltAcquires;
+        }
+        if (captureEnabled)
+        {
+            ss << " | capturing: " << captureDelivered << " frames, " << captureDropped << " dropped";
+        }
+
         glfwSetWindowTitle(window, ss.str().c_str());
+
+        ogl::state.endFrame();
+    }
+
+    // Finish the frames still being read back and encoded before Bridge goes away.
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        collectCaptures(i, true);
     }
+    reapCaptureEncodes(true);
 
     // Cleanup
     if (controller)
@@ -436,10 +797,28 @@ int main(void)
     ogl::glDeleteVertexArrays(1, &vao);
     ogl::glDeleteBuffers(1, &vbo);
     ogl::glDeleteBuffers(1, &ebo);
-    glDeleteTextures(1, &render_texture);
-    ogl::glDeleteRenderbuffers(1, &depth_buffer);
-    ogl::glDeleteFramebuffers(1, &render_fbo);
+    ogl::state.dumpStats(std::cout);
+    for (DisplayOutput& output : outputs)
+    {
+        if (outputs.size() > 1)
+        {
+            std::cout << output.name << std::endl;
+        }
+        output.quiltViews.destroy();
+        output.quiltTargets.destroy();
+        output.captureRing.destroy();
+        output.quiltTargets.dumpStats(std::cout);
+        output.captureRing.dumpStats(std::cout);
+    }
+    if (captureEncodeFailures > 0)
+    {
+        std::cout << "Capture: " << captureEncodeFailures << " frames failed to encode" << std::endl;
+    }
+
+    ogl::state.releaseProgram(shaderProgram);
+    ogl::state.releaseProgram(quiltShaderProgram);
     ogl::glDeleteProgram(shaderProgram);
+    ogl::glDeleteProgram(quiltShaderProgram);
 
     glfwTerminate();
 
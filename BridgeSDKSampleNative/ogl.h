@@ -1,3 +1,8 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
 typedef void (*PFNGLTEXIMAGE2DPROC)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void * pixels);
 
 #ifdef __APPLE__
@@ -22,6 +27,40 @@ typedef GLint (*PFNGLGETUNIFORMLOCATIONPROC)(GLuint, const GLchar*);
 typedef void (*PFNGLUNIFORMMATRIX4FVPROC)(GLint, GLsizei, GLboolean, const GLfloat*);
 typedef void (*PFNGLDELETEBUFFERSPROC)(GLsizei n, const GLuint *buffers);
 typedef void (*PFNGLDELETEPROGRAMPROC)(GLuint program);
+typedef void (*PFNGLCLIPCONTROLPROC)(GLenum origin, GLenum depth);
+typedef void (*PFNGLUNIFORM1IPROC)(GLint location, GLint v0);
+typedef void (*PFNGLUNIFORM2IPROC)(GLint location, GLint v0, GLint v1);
+typedef void (*PFNGLDrawElementsInstancedPROC)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
+typedef void (*PFNGLACTIVETEXTUREPROC)(GLenum texture);
+typedef void (*PFNGLGETACTIVEUNIFORMPROC)(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+typedef void (*PFNGLBUFFERSUBDATAPROC)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+typedef void (*PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+typedef void* (*PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef GLboolean (*PFNGLUNMAPBUFFERPROC)(GLenum target);
+typedef void (*PFNGLBINDBUFFERRANGEPROC)(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+typedef GLuint (*PFNGLGETUNIFORMBLOCKINDEXPROC)(GLuint program, const GLchar* uniformBlockName);
+typedef void (*PFNGLUNIFORMBLOCKBINDINGPROC)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+typedef GLsync (*PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+typedef GLenum (*PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (*PFNGLDELETESYNCPROC)(GLsync sync);
+#endif
+
+#ifndef GL_MAJOR_VERSION
+#define GL_MAJOR_VERSION 0x821B
+#define GL_MINOR_VERSION 0x821C
+#endif
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
+#ifndef GL_DEPTH_COMPONENT32F
+#define GL_DEPTH_COMPONENT32F 0x8CAC
+#endif
+#ifndef GL_CLIP_DISTANCE0
+#define GL_CLIP_DISTANCE0 0x3000
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
 #endif
 
 namespace ogl 
@@ -60,6 +99,22 @@ namespace ogl
     PFNGLDELETEBUFFERSPROC           glDeleteBuffers = nullptr;
     PFNGLDELETEVERTEXARRAYSPROC      glDeleteVertexArrays = nullptr;
     PFNGLDELETEPROGRAMPROC           glDeleteProgram = nullptr;
+    PFNGLCLIPCONTROLPROC             glClipControl = nullptr; // null below OpenGL 4.5
+    PFNGLUNIFORM1IPROC               glUniform1i = nullptr;
+    PFNGLUNIFORM2IPROC               glUniform2i = nullptr;
+    PFNGLDrawElementsInstancedPROC   glDrawElementsInstanced = nullptr; // spelled as in GL/glext.h
+    PFNGLACTIVETEXTUREPROC           glActiveTexture = nullptr;
+    PFNGLGETACTIVEUNIFORMPROC        glGetActiveUniform = nullptr;
+    PFNGLBUFFERSUBDATAPROC           glBufferSubData = nullptr;
+    PFNGLBUFFERSTORAGEPROC           glBufferStorage = nullptr; // null without GL_ARB_buffer_storage
+    PFNGLMAPBUFFERRANGEPROC          glMapBufferRange = nullptr;
+    PFNGLUNMAPBUFFERPROC             glUnmapBuffer = nullptr;
+    PFNGLBINDBUFFERRANGEPROC         glBindBufferRange = nullptr;
+    PFNGLGETUNIFORMBLOCKINDEXPROC    glGetUniformBlockIndex = nullptr;
+    PFNGLUNIFORMBLOCKBINDINGPROC     glUniformBlockBinding = nullptr;
+    PFNGLFENCESYNCPROC               glFenceSync = nullptr;
+    PFNGLCLIENTWAITSYNCPROC          glClientWaitSync = nullptr;
+    PFNGLDELETESYNCPROC              glDeleteSync = nullptr;
 
     void loadOpenGLFunctions() 
     {
@@ -97,6 +152,34 @@ namespace ogl
         glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)glfwGetProcAddress("glDeleteBuffers");
         glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSPROC)glfwGetProcAddress("glDeleteVertexArrays");
         glDeleteProgram = (PFNGLDELETEPROGRAMPROC)glfwGetProcAddress("glDeleteProgram");
+        glUniform1i = (PFNGLUNIFORM1IPROC)glfwGetProcAddress("glUniform1i");
+        glUniform2i = (PFNGLUNIFORM2IPROC)glfwGetProcAddress("glUniform2i");
+        glDrawElementsInstanced = (PFNGLDrawElementsInstancedPROC)glfwGetProcAddress("glDrawElementsInstanced");
+        glActiveTexture = (PFNGLACTIVETEXTUREPROC)glfwGetProcAddress("glActiveTexture");
+        glGetActiveUniform = (PFNGLGETACTIVEUNIFORMPROC)glfwGetProcAddress("glGetActiveUniform");
+        glBufferSubData = (PFNGLBUFFERSUBDATAPROC)glfwGetProcAddress("glBufferSubData");
+        glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)glfwGetProcAddress("glMapBufferRange");
+        glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)glfwGetProcAddress("glUnmapBuffer");
+        glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC)glfwGetProcAddress("glBindBufferRange");
+        glGetUniformBlockIndex = (PFNGLGETUNIFORMBLOCKINDEXPROC)glfwGetProcAddress("glGetUniformBlockIndex");
+        glUniformBlockBinding = (PFNGLUNIFORMBLOCKBINDINGPROC)glfwGetProcAddress("glUniformBlockBinding");
+        glFenceSync = (PFNGLFENCESYNCPROC)glfwGetProcAddress("glFenceSync");
+        glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)glfwGetProcAddress("glClientWaitSync");
+        glDeleteSync = (PFNGLDELETESYNCPROC)glfwGetProcAddress("glDeleteSync");
+
+        // Some loaders return an address for any name, so check the version first.
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 5))
+        {
+            glClipControl = (PFNGLCLIPCONTROLPROC)glfwGetProcAddress("glClipControl");
+        }
+
+        if (major > 4 || (major == 4 && minor >= 4) || glfwExtensionSupported("GL_ARB_buffer_storage"))
+        {
+            glBufferStorage = (PFNGLBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+        }
     }
 
     GLuint loadShader(const char* source, GLenum type) 
@@ -134,6 +217,671 @@ namespace ogl
         glDeleteShader(fragmentShader);
         return program;
     }
+
+    // Per-view matrices of a quilt in one std140 uniform buffer, written once per frame
+    // so a view only needs a glUniform1i before its draw. The shader declares
+    //
+    //   struct QuiltView { mat4 view; mat4 projection; };
+    //   layout (std140) uniform QuiltViews { QuiltView views[128]; };
+    //
+    // and indexes views[] with the value bindView returns. With buffer storage the
+    // buffer is mapped once and holds FrameCount frames, each fenced until the GPU has
+    // read it; without it a single frame is refilled with glBufferSubData.
+    class QuiltViewBuffer
+    {
+    public:
+        static const int        FrameCount = 3;
+        static const int        BlockViews = 128;   // 16 KB, the smallest GL_MAX_UNIFORM_BLOCK_SIZE
+        static const GLsizeiptr ViewSize = 32 * sizeof(GLfloat);
+        static const GLsizeiptr BlockSize = BlockViews * ViewSize;
+
+        void create(GLuint program, GLuint bindingPoint)
+        {
+            binding = bindingPoint;
+            glUniformBlockBinding(program, glGetUniformBlockIndex(program, "QuiltViews"), binding);
+        }
+
+        bool isPersistent() const { return mapped != nullptr; }
+
+        // Stalls only if the GPU still reads the frame written FrameCount frames ago.
+        void upload(const LKGCamera::QuiltMatrices& matrices)
+        {
+            int views = static_cast<int>(matrices.view.size());
+            int blocks = (views + BlockViews - 1) / BlockViews;
+            if (blocks > capacityBlocks)
+            {
+                reserve(blocks);
+            }
+
+            char* dst = nullptr;
+            if (mapped)
+            {
+                waitForFrame(frame);
+                dst = mapped + frameOffset();
+            }
+            else
+            {
+                staging.resize(size_t(views) * ViewSize);
+                dst = staging.data();
+            }
+
+            for (int viewIndex = 0; viewIndex < views; viewIndex++)
+            {
+                memcpy(dst + viewIndex * ViewSize, matrices.view[viewIndex].m, 16 * sizeof(GLfloat));
+                memcpy(dst + viewIndex * ViewSize + 16 * sizeof(GLfloat), matrices.projection[viewIndex].m, 16 * sizeof(GLfloat));
+            }
+
+            if (!mapped)
+            {
+                // Orphan the old storage so the driver need not wait for last frame's draws.
+                glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+                glBufferData(GL_UNIFORM_BUFFER, capacityBlocks * BlockSize, nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_UNIFORM_BUFFER, 0, views * ViewSize, staging.data());
+            }
+
+            boundBlock = -1;
+        }
+
+        // Binds the block holding viewIndex if it is not bound yet and returns the
+        // view's index within views[].
+        GLint bindView(int viewIndex)
+        {
+            int block = viewIndex / BlockViews;
+            if (block != boundBlock)
+            {
+                glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, frameOffset() + block * BlockSize, BlockSize);
+                boundBlock = block;
+            }
+            return viewIndex % BlockViews;
+        }
+
+        // Call after the last draw of the frame that reads the buffer.
+        void endFrame()
+        {
+            if (mapped)
+            {
+                fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                frame = (frame + 1) % FrameCount;
+            }
+        }
+
+        void destroy()
+        {
+            for (int i = 0; i < FrameCount; i++)
+            {
+                waitForFrame(i);
+            }
+
+            if (mapped)
+            {
+                glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+                glUnmapBuffer(GL_UNIFORM_BUFFER);
+                mapped = nullptr;
+            }
+
+            if (buffer)
+            {
+                glDeleteBuffers(1, &buffer);
+                buffer = 0;
+            }
+
+            capacityBlocks = 0;
+            frame = 0;
+            boundBlock = -1;
+        }
+
+    private:
+        GLuint            buffer = 0;
+        GLuint            binding = 0;
+        char*             mapped = nullptr;
+        GLsync            fences[FrameCount] = {};
+        int               frame = 0;
+        int               capacityBlocks = 0;
+        int               boundBlock = -1;
+        std::vector<char> staging;
+
+        // Whole blocks keep every range a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+        GLintptr frameOffset() const
+        {
+            return GLintptr(frame) * capacityBlocks * BlockSize;
+        }
+
+        void waitForFrame(int index)
+        {
+            if (fences[index])
+            {
+                while (glClientWaitSync(fences[index], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+                {
+                }
+                glDeleteSync(fences[index]);
+                fences[index] = nullptr;
+            }
+        }
+
+        void reserve(int blocks)
+        {
+            destroy();
+            capacityBlocks = blocks;
+
+            if (glBufferStorage)
+            {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                GLsizeiptr size = FrameCount * blocks * BlockSize;
+                glGenBuffers(1, &buffer);
+                glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+                glBufferStorage(GL_UNIFORM_BUFFER, size, nullptr, flags);
+                mapped = static_cast<char*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags));
+                if (mapped)
+                {
+                    return;
+                }
+
+                // Immutable storage cannot be respecified, so fall back on a new buffer.
+                glDeleteBuffers(1, &buffer);
+            }
+
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+            glBufferData(GL_UNIFORM_BUFFER, blocks * BlockSize, nullptr, GL_STREAM_DRAW);
+        }
+    };
+
+    // Two or three quilt render targets used in turn, so the next quilt can be
+    // rendered while Bridge still reads the previous one. Each target is fenced once
+    // its texture has been handed to Bridge, and acquire() only waits when the ring
+    // comes back round to a target whose fence has not signaled yet. The fence is in
+    // this context's command stream, so it covers Bridge's reads as long as the interop
+    // draw is issued on this context. The targets share one depth buffer.
+    class QuiltTargetRing
+    {
+    public:
+        static const int MaxTargets = 3;
+
+        struct Target
+        {
+            GLuint texture = 0;
+            GLuint framebuffer = 0;
+            GLsync fence = nullptr;
+        };
+
+        void create(int count, GLsizei width, GLsizei height, GLenum depthFormat)
+        {
+            targetCount = count < 1 ? 1 : (count > MaxTargets ? MaxTargets : count);
+            currentTarget = targetCount - 1;
+
+            glGenRenderbuffers(1, &depthBuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, width, height);
+
+            for (int i = 0; i < targetCount; i++)
+            {
+                Target& target = targets[i];
+
+                glGenTextures(1, &target.texture);
+                glBindTexture(GL_TEXTURE_2D, target.texture);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+                glGenFramebuffers(1, &target.framebuffer);
+                glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+                glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+
+        // Moves to the next target to render into, waiting for Bridge to finish with it
+        // if it has to.
+        const Target& acquire()
+        {
+            currentTarget = (currentTarget + 1) % targetCount;
+            acquireCount++;
+
+            Target& target = targets[currentTarget];
+            if (target.fence)
+            {
+                GLenum status = glClientWaitSync(target.fence, 0, 0);
+                if (status == GL_TIMEOUT_EXPIRED)
+                {
+                    auto start = std::chrono::high_resolution_clock::now();
+                    while (glClientWaitSync(target.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+                    {
+                    }
+                    waitCount++;
+                    waitMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+                }
+                glDeleteSync(target.fence);
+                target.fence = nullptr;
+            }
+
+            return target;
+        }
+
+        // The target last acquired, i.e. the newest complete quilt once it is drawn.
+        const Target& current() const
+        {
+            return targets[currentTarget];
+        }
+
+        // Call after handing current().texture to Bridge.
+        void release()
+        {
+            Target& target = targets[currentTarget];
+            if (target.fence)
+            {
+                glDeleteSync(target.fence);
+            }
+            target.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        void destroy()
+        {
+            for (int i = 0; i < targetCount; i++)
+            {
+                Target& target = targets[i];
+                if (target.fence)
+                {
+                    glDeleteSync(target.fence);
+                }
+                glDeleteFramebuffers(1, &target.framebuffer);
+                glDeleteTextures(1, &target.texture);
+                target = Target();
+            }
+
+            if (depthBuffer)
+            {
+                glDeleteRenderbuffers(1, &depthBuffer);
+                depthBuffer = 0;
+            }
+            targetCount = 0;
+        }
+
+        int count() const { return targetCount; }
+        unsigned long long acquires() const { return acquireCount; }
+        unsigned long long waits() const { return waitCount; }
+
+        void dumpStats(std::ostream& out) const
+        {
+            out << "Quilt targets: " << targetCount << ", waited on " << waitCount << " of " << acquireCount << " acquires";
+            if (waitCount > 0)
+            {
+                out << ", " << waitMicroseconds / double(waitCount) << " us per wait";
+            }
+            out << std::endl;
+        }
+
+    private:
+        Target             targets[MaxTargets];
+        GLuint             depthBuffer = 0;
+        int                targetCount = 0;
+        int                currentTarget = 0;
+        unsigned long long acquireCount = 0;
+        unsigned long long waitCount = 0;
+        double             waitMicroseconds = 0.0;
+    };
+
+    // Reads textures back through a ring of pixel pack buffers, so capturing a frame
+    // never stalls on glReadPixels. capture() starts an asynchronous copy into the next
+    // buffer and fences it; collect() maps the buffers whose copy has finished, usually
+    // a frame or two later, and hands each frame to a callback as top-down RGBA rows.
+    // If every buffer is still in flight capture() drops the frame instead of waiting.
+    class CaptureRing
+    {
+    public:
+        static const int MaxSlots = 4;
+
+        void create(int slots)
+        {
+            slotCount = slots < 2 ? 2 : (slots > MaxSlots ? MaxSlots : slots);
+            glGenFramebuffers(1, &readFramebuffer);
+        }
+
+        // Leaves GL_READ_FRAMEBUFFER and GL_PIXEL_PACK_BUFFER unbound.
+        bool capture(GLuint texture, GLsizei width, GLsizei height, unsigned long long frame)
+        {
+            Slot& slot = slots[nextSlot];
+            if (slot.fence)
+            {
+                droppedCount++;
+                return false;
+            }
+
+            GLsizeiptr size = GLsizeiptr(width) * height * 4;
+            if (!slot.buffer)
+            {
+                glGenBuffers(1, &slot.buffer);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            if (slot.size != size)
+            {
+                glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+                slot.size = size;
+            }
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            slot.width = width;
+            slot.height = height;
+            slot.frame = frame;
+            nextSlot = (nextSlot + 1) % slotCount;
+            capturedCount++;
+            return true;
+        }
+
+        // Calls deliver(frame, pixels, width, height) for finished captures, oldest
+        // first, with pixels a std::vector<unsigned char> the callback may keep. With
+        // wait set it also waits for the captures still in flight.
+        template<typename Deliver>
+        void collect(Deliver&& deliver, bool wait = false)
+        {
+            for (int i = 0; i < slotCount; i++)
+            {
+                Slot& slot = slots[(nextSlot + i) % slotCount];
+                if (!slot.fence)
+                {
+                    continue;
+                }
+
+                GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+                if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED)
+                {
+                    // Later captures cannot be done before this one.
+                    break;
+                }
+                glDeleteSync(slot.fence);
+                slot.fence = nullptr;
+
+                size_t rowSize = size_t(slot.width) * 4;
+                std::vector<unsigned char> pixels(rowSize * size_t(slot.height));
+
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+                const unsigned char* mapped = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.size, GL_MAP_READ_BIT));
+                if (mapped)
+                {
+                    // GL rows start at the bottom.
+                    for (GLsizei row = 0; row < slot.height; row++)
+                    {
+                        memcpy(&pixels[size_t(slot.height - 1 - row) * rowSize], mapped + size_t(row) * rowSize, rowSize);
+                    }
+                    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                }
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+                if (!mapped)
+                {
+                    droppedCount++;
+                    continue;
+                }
+
+                deliveredCount++;
+                deliver(slot.frame, std::move(pixels), slot.width, slot.height);
+            }
+        }
+
+        void destroy()
+        {
+            for (int i = 0; i < MaxSlots; i++)
+            {
+                Slot& slot = slots[i];
+                if (slot.fence)
+                {
+                    glDeleteSync(slot.fence);
+                }
+                if (slot.buffer)
+                {
+                    glDeleteBuffers(1, &slot.buffer);
+                }
+                slot = Slot();
+            }
+
+            if (readFramebuffer)
+            {
+                glDeleteFramebuffers(1, &readFramebuffer);
+                readFramebuffer = 0;
+            }
+        }
+
+        unsigned long long captured() const { return capturedCount; }
+        unsigned long long delivered() const { return deliveredCount; }
+        unsigned long long dropped() const { return droppedCount; }
+
+        void dumpStats(std::ostream& out) const
+        {
+            out << "Capture: " << capturedCount << " frames read back, " << deliveredCount << " delivered, " << droppedCount << " dropped" << std::endl;
+        }
+
+    private:
+        struct Slot
+        {
+            GLuint             buffer = 0;
+            GLsizeiptr         size = 0;
+            GLsync             fence = nullptr;
+            GLsizei            width = 0;
+            GLsizei            height = 0;
+            unsigned long long frame = 0;
+        };
+
+        Slot               slots[MaxSlots];
+        GLuint             readFramebuffer = 0;
+        int                slotCount = 0;
+        int                nextSlot = 0;
+        unsigned long long capturedCount = 0;
+        unsigned long long deliveredCount = 0;
+        unsigned long long droppedCount = 0;
+    };
+
+    // Remembers the bindings the samples change every frame and skips calls that would
+    // not change them; uniform locations are read once per program. Anything that
+    // changes GL state behind its back, such as the Bridge interop calls, must be
+    // followed by invalidate(). dumpStats prints how many calls were issued and elided
+    // per frame.
+    class StateCache
+    {
+    public:
+        enum Call
+        {
+            UseProgram,
+            BindVertexArray,
+            BindFramebuffer,
+            BindTexture,
+            Viewport,
+            UniformLocation,
+            CallCount
+        };
+
+        static const int TextureUnits = 8;
+
+        void useProgram(GLuint program)
+        {
+            if (!elide(UseProgram, program == boundProgram))
+            {
+                glUseProgram(program);
+                boundProgram = program;
+            }
+        }
+
+        void bindVertexArray(GLuint vao)
+        {
+            if (!elide(BindVertexArray, vao == boundVertexArray))
+            {
+                glBindVertexArray(vao);
+                boundVertexArray = vao;
+            }
+        }
+
+        // Binds GL_FRAMEBUFFER, i.e. both the draw and the read framebuffer.
+        void bindFramebuffer(GLuint framebuffer)
+        {
+            if (!elide(BindFramebuffer, framebuffer == boundFramebuffer))
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                boundFramebuffer = framebuffer;
+            }
+        }
+
+        // Binds a GL_TEXTURE_2D to unit, switching the active unit if needed.
+        void bindTexture2D(int unit, GLuint texture)
+        {
+            if (!elide(BindTexture, unit == activeUnit))
+            {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                activeUnit = unit;
+            }
+
+            if (!elide(BindTexture, texture == boundTextures[unit]))
+            {
+                glBindTexture(GL_TEXTURE_2D, texture);
+                boundTextures[unit] = texture;
+            }
+        }
+
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+        {
+            bool same = viewportKnown && x == viewportRect[0] && y == viewportRect[1] && width == viewportRect[2] && height == viewportRect[3];
+            if (!elide(Viewport, same))
+            {
+                glViewport(x, y, width, height);
+                viewportRect[0] = x;
+                viewportRect[1] = y;
+                viewportRect[2] = width;
+                viewportRect[3] = height;
+                viewportKnown = true;
+            }
+        }
+
+        // Returns -1, like glGetUniformLocation, for names the program does not use.
+        // Arrays are found by their plain name as well as by "name[0]".
+        GLint uniformLocation(GLuint program, const char* name)
+        {
+            std::unordered_map<std::string, GLint>& locations = reflect(program);
+            counts[UniformLocation].elided++;
+            auto it = locations.find(name);
+            return it != locations.end() ? it->second : -1;
+        }
+
+        // Forgets everything about the current bindings; the next bind of each kind is
+        // issued even if it matches what the cache last saw.
+        void invalidate()
+        {
+            boundProgram = Unknown;
+            boundVertexArray = Unknown;
+            boundFramebuffer = Unknown;
+            activeUnit = -1;
+            for (int i = 0; i < TextureUnits; i++)
+            {
+                boundTextures[i] = Unknown;
+            }
+            viewportKnown = false;
+        }
+
+        // Call before glDeleteProgram, since GL may hand the name out again.
+        void releaseProgram(GLuint program)
+        {
+            programs.erase(program);
+            if (boundProgram == program)
+            {
+                boundProgram = Unknown;
+            }
+        }
+
+        void endFrame()
+        {
+            frames++;
+        }
+
+        void dumpStats(std::ostream& out) const
+        {
+            static const char* names[CallCount] = { "useProgram", "bindVertexArray", "bindFramebuffer", "bindTexture", "viewport", "uniformLocation" };
+            double perFrame = frames > 0 ? 1.0 / double(frames) : 0.0;
+
+            out << "GL state calls per frame over " << frames << " frames (issued / elided):" << std::endl;
+            for (int i = 0; i < CallCount; i++)
+            {
+                out << "  " << names[i] << ": " << double(counts[i].issued) * perFrame << " / " << double(counts[i].elided) * perFrame << std::endl;
+            }
+        }
+
+    private:
+        struct Counts
+        {
+            unsigned long long issued = 0;
+            unsigned long long elided = 0;
+        };
+
+        static const GLuint Unknown = 0xFFFFFFFFu;
+
+        GLuint boundProgram = Unknown;
+        GLuint boundVertexArray = Unknown;
+        GLuint boundFramebuffer = Unknown;
+        int    activeUnit = -1;
+        GLuint boundTextures[TextureUnits] = { Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown };
+        GLint  viewportRect[4] = {};
+        bool   viewportKnown = false;
+
+        std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> programs;
+        Counts             counts[CallCount];
+        unsigned long long frames = 0;
+
+        bool elide(Call call, bool redundant)
+        {
+            if (redundant)
+            {
+                counts[call].elided++;
+            }
+            else
+            {
+                counts[call].issued++;
+            }
+            return redundant;
+        }
+
+        std::unordered_map<std::string, GLint>& reflect(GLuint program)
+        {
+            auto found = programs.find(program);
+            if (found != programs.end())
+            {
+                return found->second;
+            }
+
+            std::unordered_map<std::string, GLint>& locations = programs[program];
+
+            GLint uniformCount = 0;
+            GLint maxLength = 0;
+            glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+            glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+            std::vector<GLchar> name(size_t(maxLength > 0 ? maxLength : 1));
+            for (GLint i = 0; i < uniformCount; i++)
+            {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(program, GLuint(i), GLsizei(name.size()), &length, &size, &type, name.data());
+
+                std::string uniform(name.data(), size_t(length));
+                GLint location = glGetUniformLocation(program, uniform.c_str());
+                counts[UniformLocation].issued++;
+                locations[uniform] = location;
+
+                if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+                {
+                    locations[uniform.substr(0, uniform.size() - 3)] = location;
+                }
+            }
+
+            return locations;
+        }
+    };
+
+    StateCache state;
 }
 
 inline const GLfloat* glmValuePtr(const glm::mat4& mat) 
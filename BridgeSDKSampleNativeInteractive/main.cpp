@@ -6,6 +6,8 @@
 #include <bridge.h>
 #include <bridge_utils.hpp>
 #include <LKGCamera.hpp>
+#include <bridge_quilt_layout.hpp>
+#include <bridge_quilt_schedule.hpp>
 #include <memory>
 #include <codecvt>
 #include <locale>
@@ -16,6 +18,8 @@
 #include <ogl.h>
 #include <chrono>
 #include <numeric>
+#include <deque>
+#include <future>
 
 
 #ifdef _WIN32
@@ -39,6 +43,37 @@ const char* vertexShaderSource =
     "    vertexColor = color;\n"
     "}\n";
 
+// The quilt pass reads every view's matrices from one uniform buffer, see
+// ogl::QuiltViewBuffer. With quiltSize set, instance i draws view firstView + i and
+// is moved from a full-viewport projection into its quilt cell, clipped to the cell
+// by gl_ClipDistance; with quiltSize (0, 0) it draws viewIndex into the bound viewport.
+const char* quiltVertexShaderSource =
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 position;\n"
+    "layout (location = 1) in vec3 color;\n"
+    "out vec3 vertexColor;\n"
+    "struct QuiltView { mat4 view; mat4 projection; };\n"
+    "layout (std140) uniform QuiltViews { QuiltView views[128]; };\n"
+    "uniform mat4 model;\n"
+    "uniform int viewIndex;\n"
+    "uniform int firstView;\n"
+    "uniform ivec2 quiltSize;\n"
+    "void main() {\n"
+    "    int view = viewIndex + gl_InstanceID;\n"
+    "    vec4 clip = views[view].projection * views[view].view * model * vec4(position, 1.0);\n"
+    "    gl_ClipDistance[0] = clip.w + clip.x;\n"
+    "    gl_ClipDistance[1] = clip.w - clip.x;\n"
+    "    gl_ClipDistance[2] = clip.w + clip.y;\n"
+    "    gl_ClipDistance[3] = clip.w - clip.y;\n"
+    "    if (quiltSize.x > 0) {\n"
+    "        int cell = firstView + gl_InstanceID;\n"
+    "        vec2 cellPosition = vec2(cell % quiltSize.x, quiltSize.y - 1 - cell / quiltSize.x);\n"
+    "        clip.xy = (clip.xy + clip.w * (2.0 * cellPosition + 1.0)) / vec2(quiltSize) - clip.w;\n"
+    "    }\n"
+    "    gl_Position = clip;\n"
+    "    vertexColor = color;\n"
+    "}\n";
+
 const char* fragmentShaderSource = 
     "#version 330 core\n"
     "in vec3 vertexColor;\n"
@@ -132,14 +167,92 @@ bool mousePressed = false;
 double lastX = 0.0, lastY = 0.0;
 float angleX = 0.0f, angleY = 0.0f;
 
+// Depth buffer of the quilt render target; depth_benchmark shows what each choice
+// costs. GL_DEPTH_COMPONENT24 resolves this scene as finely as GL_DEPTH_COMPONENT32
+// did, GL_DEPTH_COMPONENT16 halves the memory at much coarser depth, and
+// GL_DEPTH_COMPONENT32F switches the camera to reversed Z when glClipControl is
+// available, for the finest depth at the same size.
+const GLenum quiltDepthFormat = GL_DEPTH_COMPONENT24;
+
+// Quilt render targets used in turn, 1 to 3. With more than one the next quilt is
+// rendered while Bridge still reads the last, at the cost of another color buffer.
+const int quiltTargetCount = 3;
+
+// How the quilt pass submits its views. Instanced draws up to 128 views with one
+// glDrawElementsInstanced call, PerView is one glViewport and draw per view. PerView
+// is also used when instanced drawing is unavailable. The window title shows the
+// quilt pass's draw calls and CPU submission time for comparing the two.
+enum class QuiltRenderMode
+{
+    PerView,
+    Instanced
+};
+
+const QuiltRenderMode quiltRenderMode = QuiltRenderMode::Instanced;
+
+// What each GL call of the PerView quilt pass costs on this driver, relative to a
+// draw; QuiltDrawSchedule::Choose picks the draw order from them. These are
+// uncalibrated starting values. The window title shows the chosen order and its
+// submit time; adjust the costs to flip the order and keep whichever is faster.
+const QuiltDrawCosts quiltDrawCosts = { 4.0, 2.0, 2.0, 1.0, 1.5, 1.0 };
+
+// Everything the window and the quilt depend on. While it stays the same the render
+// loop neither redraws nor resubmits the quilt and sleeps until input arrives, so a
+// display showing static content costs next to no GPU time.
+struct FrameState
+{
+    uint64_t cameraVersion;
+    float    angleX;
+    float    angleY;
+    float    focus;
+    float    offsetMult;
+    int      framebufferWidth;
+    int      framebufferHeight;
+
+    bool operator==(const FrameState& other) const
+    {
+        return cameraVersion == other.cameraVersion &&
+               angleX == other.angleX && angleY == other.angleY &&
+               focus == other.focus && offsetMult == other.offsetMult &&
+               framebufferWidth == other.framebufferWidth && framebufferHeight == other.framebufferHeight;
+    }
+};
+
+// An idle loop wakes every idleWaitSeconds to check for changes, and hands the
+// unchanged quilt to Bridge again every idleResubmitSeconds. Set idleResubmitSeconds
+// to 0 to stop submitting while idle if the runtime keeps showing the last quilt.
+const double idleWaitSeconds = 0.25;
+const double idleResubmitSeconds = 1.0;
+
+// Set when the window system needs the window redrawn, e.g. after it was uncovered.
+bool frameRefreshRequested = true;
+
+// Press C to start or stop saving every rendered hologram, the image Bridge shows on
+// the display, as capture_NNNNNN.png. Frames are read back through ogl::CaptureRing
+// and encoded on the Controller's task pool, so recording does not stall the render
+// loop; frames it cannot keep up with are dropped and counted instead.
+bool captureEnabled = false;
+const int captureSlots = 3;
+
 float focus = -0.5f;
 float offset_mult = 1.0f;
 
-void drawScene(GLuint shaderProgram, GLuint vao, LKGCamera& camera, float normalizedView = 0.5f, bool invert = false, float offset_mult = 0.0f, float focus = 0.0f)
+void drawScene(GLuint shaderProgram, GLuint vao, const Matrix4& modelMatrix, const Matrix4& viewMatrix, const Matrix4& projectionMatrix)
 {
-    ogl::glBindVertexArray(vao);
-    ogl::glUseProgram(shaderProgram);
+    ogl::state.bindVertexArray(vao);
+    ogl::state.useProgram(shaderProgram);
+
+    // Set uniforms
+    ogl::glUniformMatrix4fv(ogl::state.uniformLocation(shaderProgram, "model"), 1, GL_FALSE, modelMatrix.m);
+    ogl::glUniformMatrix4fv(ogl::state.uniformLocation(shaderProgram, "view"), 1, GL_FALSE, viewMatrix.m);
+    ogl::glUniformMatrix4fv(ogl::state.uniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projectionMatrix.m);
 
+    // Draw the object
+    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+}
+
+void drawScene(GLuint shaderProgram, GLuint vao, LKGCamera& camera, float normalizedView = 0.5f, bool invert = false, float offset_mult = 0.0f, float focus = 0.0f)
+{
     // Compute view and projection matrices using LKGCamera
     Matrix4 viewMatrix;
     Matrix4 projectionMatrix;
@@ -147,31 +260,24 @@ void drawScene(GLuint shaderProgram, GLuint vao, LKGCamera& camera, float normal
 
     Matrix4 modelMatrix = camera.getModelMatrix(angleX, angleY);
 
-    // Set uniforms
-    ogl::glUniformMatrix4fv(ogl::glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, modelMatrix.m);
-    ogl::glUniformMatrix4fv(ogl::glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, viewMatrix.m);
-    ogl::glUniformMatrix4fv(ogl::glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projectionMatrix.m);
-
-    // Draw the object
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+    drawScene(shaderProgram, vao, modelMatrix, viewMatrix, projectionMatrix);
 }
 
 void drawQuad(GLuint shaderProgram, GLuint vao, GLuint texture)
 {
-    ogl::glActiveTexture(GL_TEXTURE0); 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    ogl::state.bindTexture2D(0, texture);
 
-    ogl::glUseProgram(shaderProgram);
+    ogl::state.useProgram(shaderProgram);
 
-    GLint texLocation = ogl::glGetUniformLocation(shaderProgram, "texture1");
+    GLint texLocation = ogl::state.uniformLocation(shaderProgram, "texture1");
     ogl::glUniform1i(texLocation, 0);
 
-    ogl::glBindVertexArray(vao);
+    ogl::state.bindVertexArray(vao);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    ogl::glBindVertexArray(0);
+    ogl::state.bindVertexArray(0);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    ogl::glUseProgram(0);
+    ogl::state.bindTexture2D(0, 0);
+    ogl::state.useProgram(0);
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) 
@@ -211,12 +317,25 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     offset_mult += static_cast<float>(xoffset) * 0.075f; // Sensitivity
 }
 
+// Key callback function
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_C && action == GLFW_PRESS)
+    {
+        captureEnabled = !captureEnabled;
+    }
+}
+
+// Window refresh callback function
+void window_refresh_callback(GLFWwindow* window)
+{
+    frameRefreshRequested = true;
+}
+
 int main(void)
 {
     GLFWwindow* window;
-    GLuint render_texture = 0;
-    GLuint render_fbo = 0;
-    GLuint depth_buffer = 0;
+    ogl::QuiltTargetRing quiltTargets;
 
     if (!glfwInit())
         return -1;
@@ -283,6 +402,16 @@ int main(void)
     BridgeWindowData bridgeData = controller ? controller->GetWindowData(wnd) : BridgeWindowData();
     bool isBridgeDataInitialized = (bridgeData.wnd != 0);
 
+    // Watch for the Looking Glass being unplugged while the sample is running
+    std::unique_ptr<DisplayHotplugMonitor> hotplug;
+    bool displayDisconnected = false;
+
+    if (isBridgeDataInitialized)
+    {
+        hotplug = std::make_unique<DisplayHotplugMonitor>(*controller);
+        hotplug->Start();
+    }
+
     std::string window_title = "";
 
     // Update window size and title if BridgeData is initialized
@@ -355,39 +484,7 @@ int main(void)
         }
 
         // Initialize OpenGL textures and framebuffers using bridgeData's quilt dimensions
-        glGenTextures(1, &render_texture);
-        glBindTexture(GL_TEXTURE_2D, render_texture);
-
-        // Set texture parameters
-        ogl::glTexImage2D(GL_TEXTURE_2D, 
-                        0, 
-                        GL_RGBA, 
-                        bridgeData.quilt_width, 
-                        bridgeData.quilt_height, 
-                        0, 
-                        GL_RGBA,
-                        GL_UNSIGNED_BYTE, 
-                        nullptr); 
-
-        // Generate and bind the renderbuffer for depth
-        ogl::glGenRenderbuffers(1, &depth_buffer);
-        ogl::glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer); 
-
-        // Create a depth buffer
-        ogl::glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, bridgeData.quilt_width, bridgeData.quilt_height);
-
-        // Generate the framebuffer
-        ogl::glGenFramebuffers(1, &render_fbo);
-        ogl::glBindFramebuffer(GL_FRAMEBUFFER, render_fbo);
-
-        // Attach the texture to the framebuffer as a color attachment
-        ogl::glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, render_texture, 0);
-
-        // Attach the renderbuffer as a depth attachment
-        ogl::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
-
-        ogl::glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        ogl::glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        quiltTargets.create(quiltTargetCount, bridgeData.quilt_width, bridgeData.quilt_height, quiltDepthFormat);
     }
     else
     {
@@ -401,9 +498,16 @@ int main(void)
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_position_callback);
     glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
 
     GLuint shaderProgram    = ogl::createProgram(vertexShaderSource, fragmentShaderSource);
     GLuint shaderProgramTex = ogl::createProgram(vertexShaderSourceTex, fragmentShaderSourceTex);
+    GLuint quiltShaderProgram = ogl::createProgram(quiltVertexShaderSource, fragmentShaderSource);
+    GLint quiltModelLocation = ogl::state.uniformLocation(quiltShaderProgram, "model");
+    GLint quiltViewIndexLocation = ogl::state.uniformLocation(quiltShaderProgram, "viewIndex");
+    GLint quiltFirstViewLocation = ogl::state.uniformLocation(quiltShaderProgram, "firstView");
+    GLint quiltSizeLocation = ogl::state.uniformLocation(quiltShaderProgram, "quiltSize");
 
     GLuint vaoCube, vboCube, eboCube;
     ogl::glGenVertexArrays(1, &vaoCube);
@@ -448,9 +552,16 @@ int main(void)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    glClearDepth(1.0f);
+    // Reversed Z clears to the far value 0 and keeps the larger depth.
+    bool reversedZ = quiltDepthFormat == GL_DEPTH_COMPONENT32F && ogl::glClipControl != nullptr;
+    if (reversedZ)
+    {
+        ogl::glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+    }
+
+    glClearDepth(reversedZ ? 0.0f : 1.0f);
     glDepthRange(0.0f, 1.0f);
-    glDepthFunc(GL_LEQUAL);
+    glDepthFunc(reversedZ ? GL_GEQUAL : GL_LEQUAL);
     glEnable(GL_DEPTH_TEST);
 
     float size = 10.0f;
@@ -464,16 +575,117 @@ int main(void)
     float farPlane = 100.0f;
 
     LKGCamera camera = LKGCamera(size, target, up, fov, viewcone, aspect, nearPlane, farPlane);
+    if (reversedZ)
+    {
+        camera.setDepthMode(LKGCamera::DepthMode::ReversedZ);
+    }
     
-    int totalViews = bridgeData.vx * bridgeData.vy;
+    LKGCamera::QuiltMatrices quiltMatrices;
+    // Setup above binds GL objects directly, so start the cache from scratch.
+    ogl::state.invalidate();
+
+    ogl::QuiltViewBuffer quiltViews;
+    quiltViews.create(quiltShaderProgram, 0);
+    bool quiltInstanced = quiltRenderMode == QuiltRenderMode::Instanced && ogl::glDrawElementsInstanced != nullptr;
+    int quiltDraws = 0;
+    float quiltSubmitMicroseconds = 0.0f;
+    QuiltLayoutTable quiltLayout(bridgeData.vx, bridgeData.vy);
+
+    // Meshes and materials of the quilt pass. The per-view path visits them in the
+    // order QuiltDrawSchedule finds cheaper; the instanced path is always object-major.
+    const QuiltDrawItem quiltObjects[] = { { quiltShaderProgram, vaoCube, 0 } };
+    const int quiltObjectCount = static_cast<int>(sizeof(quiltObjects) / sizeof(quiltObjects[0]));
+    QuiltDrawOrder quiltDrawOrder = QuiltDrawSchedule::Choose(quiltObjects, quiltObjectCount, quiltLayout.Views(), quiltDrawCosts);
+
+    ogl::CaptureRing captureRing;
+    captureRing.create(captureSlots);
+    unsigned long long captureFrame = 0;
+    unsigned long long captureEncodeFailures = 0;
+    std::deque<std::future<bool>> captureEncodes;
+
+    auto encodeCapture = [&](unsigned long long frame, std::vector<unsigned char> pixels, GLsizei width, GLsizei height)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "capture_%06llu.png", frame);
+#ifdef _WIN32
+        std::wstring filename(name, name + strlen(name));
+#else
+        std::string filename(name);
+#endif
+        captureEncodes.push_back(controller->SaveImageToFileAsync(bridgeData.wnd, filename, std::move(pixels), PixelFormats::RGBA, width, height));
+    };
+
+    // Drops finished encodes; one the full task queue rejected loses its frame.
+    auto reapCaptureEncodes = [&](bool wait)
+    {
+        while (!captureEncodes.empty() &&
+               (wait || captureEncodes.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready))
+        {
+            try
+            {
+                captureEncodeFailures += captureEncodes.front().get() ? 0 : 1;
+            }
+            catch (const std::exception&)
+            {
+                captureEncodeFailures++;
+            }
+            captureEncodes.pop_front();
+        }
+    };
 
     std::vector<float> frameTimes;
     const int maxSamples = 100; // Number of samples to calculate the average
     auto lastTime = std::chrono::high_resolution_clock::now();
+    FrameState lastFrameState = {};
+    auto lastSubmitTime = lastTime;
 
     // Rendering loop
     while (!glfwWindowShouldClose(window))
     {
+        if (controller && bridgeData.wnd != 0)
+        {
+            // The hotplug monitor polls Bridge off the render thread, so this is only
+            // an atomic check unless the set of connected displays has changed.
+            if (hotplug && hotplug->ConsumeChange())
+            {
+                displayDisconnected = !hotplug->IsConnected(displays[0].serial);
+                frameRefreshRequested = true;
+            }
+
+            if (displayDisconnected)
+            {
+                int sizeX = 0;
+                int sizeY = 0;
+                glfwGetWindowSize(window, &sizeX, &sizeY);
+
+                if (sizeX != 800 && sizeY != 800)
+                {
+                    glfwSetWindowSize(window, 800, 800);
+                }
+            }
+        }
+
+        // The framebuffer size is part of the frame state.
+        int fbWidth = 0, fbHeight = 0;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+        // Skip frames whose output would not change.
+        FrameState frameState = { camera.getVersion(), angleX, angleY, focus, offset_mult, fbWidth, fbHeight };
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        bool frameChanged = frameRefreshRequested || !(frameState == lastFrameState);
+        // Only a Bridge output has anything to resubmit; without one an idle loop sleeps.
+        bool resubmit = controller && bridgeData.wnd != 0 && idleResubmitSeconds > 0.0 &&
+                        std::chrono::duration<double>(frameStart - lastSubmitTime).count() >= idleResubmitSeconds;
+        if (!frameChanged && !resubmit)
+        {
+            glfwWaitEventsTimeout(idleWaitSeconds);
+            lastTime = std::chrono::high_resolution_clock::now();
+            continue;
+        }
+
+        lastFrameState = frameState;
+        frameRefreshRequested = false;
+
         auto currentTime = std::chrono::high_resolution_clock::now();
         float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - lastTime).count();
         lastTime = currentTime;
@@ -491,57 +703,115 @@ int main(void)
 
         glfwMakeContextCurrent(window);
 
-        if (controller && bridgeData.wnd != 0)
+        // An unchanged frame resubmits the quilt texture as it is.
+        if (controller && bridgeData.wnd != 0 && frameChanged)
         {
             // Draw the quilt views for the hologram
-            ogl::glBindFramebuffer(GL_FRAMEBUFFER, render_fbo);
+            ogl::state.bindFramebuffer(quiltTargets.acquire().framebuffer);
 
             glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            for (int y = 0; y < bridgeData.vy; y++)
+            // All views share one model matrix and only differ in their view offset and
+            // frustum shift, so compute every view's matrices once per frame.
+            Matrix4 modelMatrix = camera.getModelMatrix(angleX, angleY);
+            camera.computeQuiltMatrices(bridgeData.vx, bridgeData.vy, true, offset_mult, focus, quiltMatrices);
+            auto submitStart = std::chrono::high_resolution_clock::now();
+            quiltViews.upload(quiltMatrices);
+
+            ogl::state.useProgram(quiltShaderProgram);
+            quiltDraws = 0;
+
+            if (quiltInstanced)
             {
-                for (int x = 0; x < bridgeData.vx; x++)
+                for (int i = 0; i < 4; i++)
                 {
-                    int viewPositionX = x * bridgeData.view_width;
-
-                    int invertedY = bridgeData.vy - 1 - y;
-                    int viewPositionY = invertedY * bridgeData.view_height;
+                    glEnable(GL_CLIP_DISTANCE0 + i);
+                }
 
-                    int viewIndex = y * bridgeData.vx + x;
-                    float normalizedView = static_cast<float>(viewIndex) / static_cast<float>(totalViews - 1);
+                int views = quiltLayout.Views();
+                ogl::state.viewport(0, 0, bridgeData.vx * bridgeData.view_width, bridgeData.vy * bridgeData.view_height);
+                ogl::glUniform2i(quiltSizeLocation, bridgeData.vx, bridgeData.vy);
+                for (const QuiltDrawItem& object : quiltObjects)
+                {
+                    ogl::state.useProgram(object.program);
+                    ogl::state.bindVertexArray(object.vertexArray);
+                    ogl::state.bindTexture2D(0, object.texture);
+                    ogl::glUniformMatrix4fv(quiltModelLocation, 1, GL_FALSE, modelMatrix.m);
+
+                    for (int firstView = 0; firstView < views; firstView += ogl::QuiltViewBuffer::BlockViews)
+                    {
+                        int instances = views - firstView < ogl::QuiltViewBuffer::BlockViews ? views - firstView : ogl::QuiltViewBuffer::BlockViews;
+                        ogl::glUniform1i(quiltViewIndexLocation, quiltViews.bindView(firstView));
+                        ogl::glUniform1i(quiltFirstViewLocation, firstView);
+                        ogl::glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr, instances);
+                        quiltDraws++;
+                    }
+                }
 
-                    glViewport(viewPositionX, viewPositionY, bridgeData.view_width, bridgeData.view_height);
-                    drawScene(shaderProgram, vaoCube, camera, normalizedView, true, offset_mult, focus);
+                for (int i = 0; i < 4; i++)
+                {
+                    glDisable(GL_CLIP_DISTANCE0 + i);
                 }
             }
+            else
+            {
+                ogl::glUniform2i(quiltSizeLocation, 0, 0);
+                int lastObject = -1;
+                QuiltDrawSchedule::ForEach(quiltDrawOrder, quiltObjectCount, quiltLayout.Views(), [&](int object, int viewIndex)
+                {
+                    const QuiltDrawItem& item = quiltObjects[object];
+                    ogl::state.useProgram(item.program);
+                    ogl::state.bindVertexArray(item.vertexArray);
+                    ogl::state.bindTexture2D(0, item.texture);
+                    if (object != lastObject)
+                    {
+                        ogl::glUniformMatrix4fv(quiltModelLocation, 1, GL_FALSE, modelMatrix.m);
+                        lastObject = object;
+                    }
+
+                    const QuiltViewCell& cell = quiltLayout[viewIndex];
+                    ogl::state.viewport(cell.column * bridgeData.view_width, cell.row * bridgeData.view_height, bridgeData.view_width, bridgeData.view_height);
+                    ogl::glUniform1i(quiltViewIndexLocation, quiltViews.bindView(viewIndex));
+                    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+                    quiltDraws++;
+                });
+            }
+
+            quiltViews.endFrame();
+            float submitMicroseconds = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - submitStart).count();
+            quiltSubmitMicroseconds = quiltSubmitMicroseconds > 0.0f ? 0.95f * quiltSubmitMicroseconds + 0.05f * submitMicroseconds : submitMicroseconds;
+        }
 
-            controller->DrawInteropQuiltTextureGL(bridgeData.wnd, render_texture, PixelFormats::RGBA,
+        if (controller && bridgeData.wnd != 0)
+        {
+            controller->DrawInteropQuiltTextureGL(bridgeData.wnd, quiltTargets.current().texture, PixelFormats::RGBA,
                 bridgeData.quilt_width, bridgeData.quilt_height,
                 bridgeData.vx, bridgeData.vy, bridgeData.displayaspect, 1.0f);
+            quiltTargets.release();
+            lastSubmitTime = frameStart;
 
-            if (controller->IsDisplayDisconnected(displays[0].serial))
-            {
-                int sizeX = 0;
-                int sizeY = 0;
-                glfwGetWindowSize(window, &sizeX, &sizeY);
+            captureRing.collect(encodeCapture);
+            reapCaptureEncodes(false);
 
-                if (sizeX != 800 && sizeY != 800)
-                {
-                    glfwSetWindowSize(window, 800, 800);
-                }
-            }
+            // Bridge draws with its own GL state.
+            ogl::state.invalidate();
+        }
+
+        // The window already shows this frame unless something changed.
+        if (!frameChanged)
+        {
+            glfwPollEvents();
+            continue;
         }
 
         glfwMakeContextCurrent(window);
 
         // mlc: draw to primary head
-        ogl::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        ogl::state.bindFramebuffer(0);
 
         // mlc: retina immune viewport
-        int fbWidth = 0, fbHeight = 0;
-        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
-        glViewport(0, 0, fbWidth, fbHeight);
+        ogl::state.viewport(0, 0, fbWidth, fbHeight);
 
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -555,6 +825,11 @@ int main(void)
             PixelFormats       hologram_format = PixelFormats::NoFormat;
 
             controller->GetOffscreenWindowTextureGL(bridgeData.wnd, &hologram_texture, &hologram_format, &hologram_width, &hologram_height);
+            if (captureEnabled && hologram_texture != 0)
+            {
+                captureRing.capture((GLuint)hologram_texture, (GLsizei)hologram_width, (GLsizei)hologram_height, captureFrame++);
+            }
+            ogl::state.invalidate();
             drawQuad(shaderProgramTex, vaoQuad, (GLuint)hologram_texture);
         }
         else
@@ -572,8 +847,31 @@ int main(void)
         ss << window_title.c_str();
         ss << " ";
         ss << averageFPS;
+        if (quiltDraws > 0)
+        {
+            ss << " | quilt: " << quiltDraws << (quiltInstanced ? " instanced" : quiltDrawOrder == QuiltDrawOrder::ObjectMajor ? " object-major" : " view-major") << " draws, " << quiltSubmitMicroseconds << " us";
+            ss << ", waited " << quiltTargets.waits() << "/" << quiltTargets.acquires();
+        }
+        if (captureEnabled)
+        {
+            ss << " | capturing: " << captureRing.delivered() << " frames, " << captureRing.dropped() + captureEncodeFailures << " dropped";
+        }
 
         glfwSetWindowTitle(window, ss.str().c_str());
+
+        ogl::state.endFrame();
+    }
+
+    // Finish the frames still being read back and encoded before Bridge goes away.
+    if (controller)
+    {
+        captureRing.collect(encodeCapture, true);
+        reapCaptureEncodes(true);
+    }
+
+    if (hotplug)
+    {
+        hotplug->Stop();
     }
 
     if (controller)
@@ -587,11 +885,23 @@ int main(void)
     ogl::glDeleteVertexArrays(1, &vaoQuad);
     ogl::glDeleteBuffers(1, &vboQuad);
     ogl::glDeleteBuffers(1, &eboQuad);
-    glDeleteTextures(1, &render_texture);
-    ogl::glDeleteRenderbuffers(1, &depth_buffer);
-    ogl::glDeleteFramebuffers(1, &render_fbo);
+    quiltViews.destroy();
+    quiltTargets.destroy();
+    captureRing.destroy();
+    ogl::state.dumpStats(std::cout);
+    quiltTargets.dumpStats(std::cout);
+    captureRing.dumpStats(std::cout);
+    if (captureEncodeFailures > 0)
+    {
+        std::cout << "Capture: " << captureEncodeFailures << " frames failed to encode" << std::endl;
+    }
+
+    ogl::state.releaseProgram(shaderProgram);
+    ogl::state.releaseProgram(shaderProgramTex);
+    ogl::state.releaseProgram(quiltShaderProgram);
     ogl::glDeleteProgram(shaderProgram);
     ogl::glDeleteProgram(shaderProgramTex);
+    ogl::glDeleteProgram(quiltShaderProgram);
 
     glfwTerminate();
 